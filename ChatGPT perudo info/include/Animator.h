@@ -0,0 +1,77 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <cstddef>
+#include <vector>
+
+enum class Ease { Linear, OutCubic, InOutQuad, OutBack };
+
+float applyEase(Ease ease, float t);
+
+// Animator owns every animated value in the scene as a numbered channel.
+//
+// Channels advance in fixed steps of `step` seconds, whatever the frame
+// rate: update() consumes real elapsed time and runs as many whole steps
+// as fit, and value() blends the last two steps so motion stays smooth
+// between them. Channel state is kept as parallel arrays (one vector per
+// field) and every step walks them front to back.
+class Animator {
+public:
+    using Id = std::size_t;
+
+    static constexpr float step = 1.f / 120.f;
+    static constexpr int maxStepsPerUpdate = 30; // longer stalls are dropped, not replayed
+
+    // Returns a new channel resting at `initial`
+    Id add(float initial = 0.f);
+
+    // Moves `channel` from `from` to `to` over `duration` seconds, holding
+    // `from` for `delay` seconds first. Replaces any tween already running.
+    void tween(Id channel, float from, float to, float duration, Ease ease = Ease::Linear, float delay = 0.f);
+
+    // Stops the channel at `value`
+    void set(Id channel, float value);
+
+    // Returns true if any channel moved, including the step a tween ends on.
+    // Tweens still in their delay do not count.
+    bool update(sf::Time elapsed);
+
+    // Time until a running channel next moves: zero while one is moving,
+    // otherwise the shortest delay left. Only meaningful while anyRunning().
+    sf::Time untilNextChange() const;
+
+    // Interpolated between the previous and the current step
+    float value(Id channel) const;
+
+    bool running(Id channel) const { return active[channel] != 0; }
+    bool anyRunning() const { return runningCount > 0; }
+
+private:
+    // One entry per channel in each array
+    std::vector<float> from, to;
+    std::vector<float> delay, duration, elapsed;
+    std::vector<Ease> ease;
+    std::vector<float> previous, current;
+    std::vector<unsigned char> active;
+
+    std::size_t runningCount = 0;
+    float accumulator = 0.f;
+
+    bool advance(); // true if any channel changed
+};
+
+// A timeline is a list of tweens with start times relative to play().
+// Build it once and replay it; the channels are the only state.
+class Timeline {
+public:
+    Timeline& add(float at, Animator::Id channel, float from, float to, float duration, Ease ease = Ease::Linear);
+    void play(Animator& animator) const;
+
+private:
+    struct Track {
+        float at;
+        Animator::Id channel;
+        float from, to, duration;
+        Ease ease;
+    };
+    std::vector<Track> tracks;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "ResourceManager.h"
+#include "AssetPack.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Loads the client's startup assets without blocking the first frame.
+//
+// A worker thread reads and decodes everything (PNG decoding and atlas
+// packing included), taking files from the asset pack when one exists.
+// The render thread calls update() once per frame, which hands finished
+// work to SFML and uploads the atlas a band of rows at a time until the
+// frame's budget is spent, so a slow disk or a large sheet never stalls
+// a frame.
+class AssetLoader {
+public:
+    AssetLoader(std::vector<std::pair<std::string, std::string>> atlasFiles, std::string fontFile,
+        std::string packFile = "assets/perudo.pack");
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    ~AssetLoader();
+
+    // Render thread only
+    void update(sf::Time budget);
+    bool atlasReady() const { return atlasInstalled; }
+    bool fontReady() const { return fontLoaded; }
+    bool loading() const { return !atlasInstalled || !(fontLoaded || fontFailed); }
+    const sf::Font& getFont() const { return font; }
+
+private:
+    std::vector<std::pair<std::string, std::string>> atlasFiles;
+    std::string fontFile;
+    std::string packFile;
+    AssetPack pack; // opened by the worker; stays mapped while the font uses it
+    std::thread worker;
+
+    // Produced by the worker, guarded by `mutex`
+    std::mutex mutex;
+    std::unique_ptr<PackedAtlas> packed;
+    std::unique_ptr<std::vector<char>> fontBytes; // loose font file
+    AssetPack::Blob fontBlob;                     // font inside the pack
+    bool fontMissing = false;
+
+    // Render thread state
+    std::unique_ptr<PackedAtlas> uploading;
+    std::unique_ptr<sf::Texture> atlas;
+    unsigned uploadedRows = 0;
+    bool atlasInstalled = false;
+    std::vector<char> fontData; // sf::Font reads from it (or from the pack) for its whole lifetime
+    sf::Font font;
+    bool fontLoaded = false;
+    bool fontFailed = false;
+
+    void load(); // worker thread
+};
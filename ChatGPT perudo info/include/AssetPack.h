@@ -0,0 +1,65 @@
+#pragma once
+#include <SFML/Config.hpp>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+// Read-only view of a packed asset archive, mapped into memory once.
+//
+// Layout (native little-endian):
+//   Header             magic "PRDOPACK", version, entry count
+//   Entry[count]       fixed-size index records
+//   blobs              each starting on a `alignment` boundary
+//
+// A blob is either a file's bytes as they were on disk (fonts, sounds),
+// or an image already decoded to RGBA so loading it skips PNG decoding.
+// Entries are named by the path the loose file would have, which lets
+// callers look up the pack first and fall back to the disk.
+class AssetPack {
+public:
+    static constexpr sf::Uint32 Version = 1;
+    static constexpr std::size_t alignment = 64;
+
+    enum class Kind : sf::Uint32 { File = 0, Rgba = 1 };
+
+    struct Header {
+        char magic[8];
+        sf::Uint32 version;
+        sf::Uint32 count;
+    };
+    struct Entry {
+        char name[64]; // zero-terminated
+        Kind kind;
+        sf::Uint32 width, height; // Rgba only
+        sf::Uint32 reserved;
+        sf::Uint64 offset, size;  // from the start of the file
+    };
+
+    struct Blob {
+        Kind kind = Kind::File;
+        unsigned width = 0, height = 0;
+        const void* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    AssetPack() = default;
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+    ~AssetPack();
+
+    // Maps `path` and validates its index; false leaves the pack closed
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    bool find(const std::string& name, Blob& out) const;
+
+private:
+    const char* base = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+    std::unordered_map<std::string, Blob> index;
+};
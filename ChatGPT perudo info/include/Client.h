@@ -1,7 +1,13 @@
 #pragma once
 #include <SFML/Network.hpp>
+#include "ClientSession.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <map>
+#include <thread>
 #include <vector>
 
 struct ClientPlayerState {
@@ -9,14 +15,30 @@ struct ClientPlayerState {
     std::vector<int> revealedDice; // used for MYDICE (self) and REVEAL (others)
 };
 
+// Socket I/O and decoding run on the client's own network thread, which
+// hands decoded events to the render thread through one SPSC queue and
+// takes commands back through another. Everything below, state included,
+// belongs to the thread that calls poll().
 class Client {
 public:
+    Client() = default;
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+    ~Client();
+
+    // Starts connecting in the background and returns at once; `connected`
+    // turns true from the poll() that applies the connection.
     bool connectToServer(const std::string& ip, unsigned short port, const std::string& username);
     bool requestRoll();
     bool sendBet(int count, int face);
     bool sendDoubt();
     bool sendNextRound();
-    bool poll();
+    // Applies every event the network thread has queued, stopping early
+    // once `budget` has been spent. Returns how many were applied.
+    int poll(sf::Time budget = sf::microseconds(2000));
+    // Blocks until the network thread has queued an event or `timeout`
+    // passes. Lets an idle render loop sleep instead of spinning.
+    void waitForEvents(sf::Time timeout);
 
     // Public state for UI
     std::string myUsername = "Player";
@@ -27,10 +49,56 @@ public:
     std::string currentBetter;
     int currentBetCount = 0;
     int currentBetFace = 0;
-    std::string lastMessage;    // last top-level token
+    std::string lastMessage;    // last top-level token of the latest poll
+    unsigned myDiceSerial = 0;  // bumped by every MYDICE, even mid-batch
 
     std::map<std::string, ClientPlayerState> players;
 
 private:
-    sf::TcpSocket socket;
+    ClientSession session;               // owned by the network thread once started
+    SpscQueue<ServerEvent> events{ 1024 };  // network thread -> poll()
+    SpscQueue<ClientCommand> commands{ 64 }; // send*() -> network thread
+    std::thread network;
+    std::atomic<bool> running{ false };
+    std::mutex wakeMutex;                // pairs with `wake` for waitForEvents()
+    std::condition_variable wake;
+
+    // Loopback datagrams wake the network thread out of its selector when
+    // a command is queued. The receiver belongs to the network thread, the
+    // sender to the thread that calls send*().
+    sf::UdpSocket wakeReceiver, wakeSender;
+    unsigned short wakePort = 0;         // 0 = no wake socket; the selector polls instead
+
+    std::vector<std::string> namesById;  // binary protocol player ids
+    proto::Seq lastSeq = 0;              // sequence number of the last applied delta
+    bool synced = false;                 // false until a Snapshot arrives, and after a gap
+
+    void networkLoop(std::string ip, unsigned short port, std::string username);
+    bool connectWithBackoff(const std::string& ip, unsigned short port, const std::string& username);
+    bool sendCommand(ClientCommand cmd);
+    void notifyEvents();
+    void wakeNetwork();
+
+    // One overload per event, run on the poll() thread
+    void apply(const TextLine& e);
+    void apply(const Connected& e);
+    void apply(const Disconnected& e);
+    void apply(const proto::Snapshot& m);
+    void apply(const proto::Player& m);
+    void apply(const proto::DiceCount& m);
+    void apply(const proto::Phase& m);
+    void apply(const proto::Turn& m);
+    void apply(const proto::CurrentBet& m);
+    void apply(const proto::Reveal& m);
+    void apply(const proto::MyDice& m);
+    void apply(const proto::Info& m);
+    void apply(const proto::Reject& m);
+
+    std::string nameOf(sf::Uint8 id) const;
+    bool inSequence(proto::Seq seq); // false = skip this delta
+
+    // State updates shared by both wire formats
+    void applyPhase(const std::string& newPhase);
+    void applyCurrentBet(const std::string& who, int count, int face);
+    void applyMyDice(const std::vector<int>& dice);
 };
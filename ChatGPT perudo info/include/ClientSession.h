@@ -0,0 +1,60 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include "Protocol.h"
+#include <deque>
+#include <functional>
+#include <string>
+#include <variant>
+
+// Text-protocol line, interpreted by whoever consumes the event
+struct TextLine { std::string line; };
+struct Connected {};
+struct Disconnected {};
+
+// Everything a server can send to a client, already decoded
+using ServerEvent = std::variant<TextLine, Connected, Disconnected,
+    proto::Snapshot, proto::Player, proto::DiceCount, proto::Phase, proto::Turn,
+    proto::CurrentBet, proto::Reveal, proto::MyDice, proto::Info, proto::Reject>;
+
+// Everything a client can ask of its table
+using ClientCommand = std::variant<proto::Roll, proto::Bet, proto::Doubt, proto::Next, proto::Resync>;
+
+// One connection to the server: the socket plus both wire formats. It is
+// single-threaded and knows nothing about game state, so the UI client
+// can drive it from a network thread and a headless bot from a loop.
+class ClientSession {
+public:
+    // Connects, offers the binary protocol and sends HELLO. Gives up after
+    // `timeout`, or early once `keepWaiting` returns false; it is asked
+    // every few milliseconds while the handshake is in flight.
+    bool connect(const std::string& ip, unsigned short port, const std::string& username, sf::Time timeout,
+                 const std::function<bool()>& keepWaiting = {});
+    void disconnect();
+
+    // Queues the command behind any earlier output the socket has not
+    // taken yet; false only if the connection has failed
+    bool send(const ClientCommand& cmd);
+    // Retries queued output. receive() does this first, so a loop that
+    // keeps calling receive() never strands a command under backpressure.
+    bool flush();
+    bool hasPendingOutput() const { return !outbox.empty(); }
+    // Decodes one waiting message into `out`; false when nothing is waiting.
+    // A lost connection is reported once, as a Disconnected event.
+    bool receive(ServerEvent& out);
+
+    // Connect/disconnect messages on stdout/stderr; off for bot swarms
+    void setLogging(bool on) { logging = on; }
+
+    bool isConnected() const { return connected; }
+    sf::TcpSocket& getSocket() { return socket; }
+
+private:
+    sf::TcpSocket socket;
+    bool connected = false;
+    sf::Uint8 protocol = 0; // 0 = text lines until the server acks PROTO
+    bool logging = true;
+    std::deque<sf::Packet> outbox; // front may be partly sent already
+
+    bool sendPacket(sf::Packet& p);
+    bool decodeBinary(const sf::Packet& p, ServerEvent& out);
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include "SendQueue.h"
+#include <memory>
+#include <string>
+
+class Table;
+
+// One accepted client socket. A connection is seated at a Table when it
+// sends HELLO; until then `table` is null and game messages are ignored.
+//
+// Outgoing messages are queued as shared Frames and only written by
+// flush(), so everything produced while handling one inbound message
+// reaches the socket in a single send call. Whatever the socket does not
+// take stays queued until it is writable again. A peer that lets the queue
+// grow past softQueueLimit without draining for stallTimeout, or past
+// hardQueueLimit at all, is a slow consumer and gets disconnected.
+struct Connection {
+    static constexpr std::size_t softQueueLimit = 64 * 1024;
+    static constexpr std::size_t hardQueueLimit = 1024 * 1024;
+    static constexpr sf::Int32 stallTimeoutMs = 5000;
+
+    std::unique_ptr<sf::TcpSocket> socket;
+    Table* table = nullptr;
+    sf::Uint8 protocol = 0; // 0 = text lines, otherwise the negotiated proto::Version
+    bool closing = false;   // failed; will be dropped at the end of this loop turn
+
+    void send(Frame frame);
+    void send(const sf::Packet& packet) { send(makeFrame(packet)); }
+    void sendLine(const std::string& line);
+
+    // Writes as much of the queue as the socket takes, in one system call
+    // where the platform allows. False once the socket has failed.
+    bool flush();
+
+    bool isSlowConsumer() const;
+    // Milliseconds until isSlowConsumer() could become true, or -1.
+    sf::Int32 msUntilStalled() const;
+
+    // Monitoring
+    std::size_t queuedBytes() const { return outbox.size(); }
+    std::size_t peakQueuedBytes() const { return peakQueued; }
+
+private:
+    SendQueue outbox;
+    std::size_t peakQueued = 0;
+    bool overflowed = false;   // a message was refused at hardQueueLimit
+    sf::Clock lastProgress;    // restarted whenever the queue drains a little
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+// DiceBatch draws every die and cup on the table as persistent quads.
+//
+// The caller registers each picture once (a texture plus sub-rect) and
+// then places numbered slots every frame. A slot's four vertices are only
+// rewritten when its picture, centre or size actually changed. Quads are
+// grouped into one sf::VertexArray per texture, so a frame costs one draw
+// call per texture in use, however many dice are showing.
+class DiceBatch {
+public:
+    static constexpr std::size_t slotsPerSeat = 6; // cup + up to five dice
+
+    explicit DiceBatch(std::size_t seats);
+
+    // Returns the image id used by place()
+    int addImage(const sf::Texture& texture, const sf::IntRect& rect);
+
+    // Shows `image` in `slot`, centred at `center` and scaled to `size`
+    void place(std::size_t slot, int image, sf::Vector2f center, sf::Vector2f size);
+    void hide(std::size_t slot);
+
+    static std::size_t slotOf(std::size_t seat, std::size_t index) { return seat * slotsPerSeat + index; }
+
+    void draw(sf::RenderTarget& target) const;
+
+private:
+    struct Image {
+        std::size_t layer;
+        sf::FloatRect uv;
+    };
+    struct Layer {
+        const sf::Texture* texture;
+        sf::VertexArray quads;  // four vertices per slot; hidden slots are collapsed
+        std::size_t shown = 0;  // slots currently visible in this layer
+    };
+    struct Slot {
+        int image = -1; // -1 = hidden
+        sf::Vector2f center, size;
+    };
+
+    std::vector<Image> images;
+    std::vector<Layer> layers;
+    std::vector<Slot> slots;
+
+    void writeQuad(std::size_t slot);
+    void collapseQuad(std::size_t layer, std::size_t slot);
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include "PerudoRules.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PERUDO_DICE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PERUDO_DICE_SSE2 1
+#endif
+
+namespace perudo {
+
+// One round's dice for a whole table: every die is a byte (1..6) in a single
+// contiguous array, and each player's hand is an offset and a count into it.
+// Once the dice are filled in, tally() builds a face histogram per hand and
+// for the whole table, so counts for any bid are lookups from then on.
+class DicePool {
+public:
+    struct Hand {
+        std::uint8_t owner;  // caller's player id
+        std::uint32_t offset, count;
+        FaceCounts faces;    // valid after tally()
+    };
+
+    void clear() { dice.clear(); hands.clear(); totals.fill(0); }
+
+    // Appends a hand of `count` dice and returns it for filling in. The
+    // pointer is only valid until the next add(); to fill every hand in
+    // one go, add them all and then write through data().
+    std::uint8_t* add(std::uint8_t owner, std::size_t count) {
+        hands.push_back({ owner, (std::uint32_t)dice.size(), (std::uint32_t)count, {} });
+        dice.resize(dice.size() + count);
+        return dice.data() + hands.back().offset;
+    }
+
+    // Call once the round's dice are final
+    void tally() {
+        totals.fill(0);
+        for (Hand& h : hands) {
+            h.faces = tallyFaces(begin(h), end(h));
+            for (std::size_t f = 0; f < totals.size(); ++f) totals[f] += h.faces[f];
+        }
+    }
+
+    // Whole table, as of the last tally()
+    const FaceCounts& faces() const { return totals; }
+
+    const Hand* find(std::uint8_t owner) const {
+        for (const Hand& h : hands)
+            if (h.owner == owner) return &h;
+        return nullptr;
+    }
+
+    const std::vector<Hand>& getHands() const { return hands; }
+    const std::uint8_t* begin(const Hand& h) const { return dice.data() + h.offset; }
+    const std::uint8_t* end(const Hand& h) const { return dice.data() + h.offset + h.count; }
+
+    std::uint8_t* data() { return dice.data(); }
+    const std::uint8_t* data() const { return dice.data(); }
+    std::size_t size() const { return dice.size(); }
+
+private:
+    std::vector<std::uint8_t> dice;
+    std::vector<Hand> hands;
+    FaceCounts totals{};
+};
+
+// ---- Counting kernels ----
+// Every kernel counts the dice equal to `face` or to `alt`. Passing
+// alt == face counts one face; passing alt == 1 adds wild ones. The rule
+// variant is resolved once per call (wildAlt), so the per-die work is the
+// same two compares for ones bids, wild ones and palifico alike.
+
+template <class R>
+constexpr std::uint8_t wildAlt(std::uint8_t face, bool palifico) {
+    return matches<R>(1, face, palifico) ? 1 : face;
+}
+
+inline std::size_t countFaceScalar(const std::uint8_t* d, std::size_t n, std::uint8_t face, std::uint8_t alt) {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < n; ++i) total += (std::size_t)((d[i] == face) | (d[i] == alt));
+    return total;
+}
+
+#if defined(PERUDO_DICE_SSE2) || defined(PERUDO_DICE_AVX2)
+// Matches are accumulated as bytes (subtracting the 0xFF compare masks)
+// for at most 255 vectors, then widened with a sum of absolute differences.
+inline std::size_t countFaceSse2(const std::uint8_t* d, std::size_t n, std::uint8_t face, std::uint8_t alt) {
+    const __m128i vf = _mm_set1_epi8((char)face), va = _mm_set1_epi8((char)alt), zero = _mm_setzero_si128();
+    std::size_t i = 0, total = 0;
+    while (n - i >= 16) {
+        std::size_t blockEnd = i + std::min<std::size_t>((n - i) / 16, 255) * 16;
+        __m128i acc = zero;
+        for (; i < blockEnd; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i));
+            acc = _mm_sub_epi8(acc, _mm_or_si128(_mm_cmpeq_epi8(v, vf), _mm_cmpeq_epi8(v, va)));
+        }
+        __m128i sums = _mm_sad_epu8(acc, zero);
+        total += (std::size_t)_mm_cvtsi128_si32(sums) + (std::size_t)_mm_extract_epi16(sums, 4);
+    }
+    return total + countFaceScalar(d + i, n - i, face, alt);
+}
+#endif
+
+#if defined(PERUDO_DICE_AVX2)
+inline std::size_t countFaceAvx2(const std::uint8_t* d, std::size_t n, std::uint8_t face, std::uint8_t alt) {
+    const __m256i vf = _mm256_set1_epi8((char)face), va = _mm256_set1_epi8((char)alt), zero = _mm256_setzero_si256();
+    std::size_t i = 0, total = 0;
+    while (n - i >= 32) {
+        std::size_t blockEnd = i + std::min<std::size_t>((n - i) / 32, 255) * 32;
+        __m256i acc = zero;
+        for (; i < blockEnd; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+            acc = _mm256_sub_epi8(acc, _mm256_or_si256(_mm256_cmpeq_epi8(v, vf), _mm256_cmpeq_epi8(v, va)));
+        }
+        alignas(32) std::uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_sad_epu8(acc, zero));
+        total += (std::size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+    return total + countFaceSse2(d + i, n - i, face, alt);
+}
+#endif
+
+// Widest kernel this build targets (AVX2 needs -mavx2 or /arch:AVX2)
+inline std::size_t countFace(const std::uint8_t* d, std::size_t n, std::uint8_t face, std::uint8_t alt) {
+#if defined(PERUDO_DICE_AVX2)
+    return countFaceAvx2(d, n, face, alt);
+#elif defined(PERUDO_DICE_SSE2)
+    return countFaceSse2(d, n, face, alt);
+#else
+    return countFaceScalar(d, n, face, alt);
+#endif
+}
+
+inline const char* countFaceKernel() {
+#if defined(PERUDO_DICE_AVX2)
+    return "avx2";
+#elif defined(PERUDO_DICE_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+// Dice on the whole table that count towards a bid on `face`, from the
+// tally (constant time) or by scanning every die (no tally needed)
+template <class R>
+int countMatching(const DicePool& pool, std::uint8_t face, bool palifico) {
+    return countMatching<R>(pool.faces(), face, palifico);
+}
+
+template <class R>
+int scanMatching(const DicePool& pool, std::uint8_t face, bool palifico) {
+    return (int)countFace(pool.data(), pool.size(), face, wildAlt<R>(face, palifico));
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace perudo {
+
+// Dice generator: xoshiro256** with its state expanded from (seed, stream)
+// by splitmix64. Every table, or simulated chunk of games, takes its own
+// stream of one logged seed, so any game can be replayed from the seed and
+// its stream number, and no two streams share state.
+//
+// rollD6() gets twenty dice from each 64-bit output. Each 32-bit half x is
+// read as a fraction x / 2^32 and its first ten base-6 digits are the dice:
+// digit i is the top of 6 * (x * 6^i mod 2^32), so the ten are independent
+// multiplies rather than a chain. Together they are floor(x * 6^10 / 2^32),
+// and Lemire's test on the low bits of x * 6^10 makes them exactly uniform
+// (it rejects about one half in 2300). Dice a call does not use wait in a
+// small reservoir for the next one, so rolling a hand of five costs a
+// quarter of a draw.
+class DiceRng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit DiceRng(std::uint64_t seed = 0, std::uint64_t stream = 0) { reseed(seed, stream); }
+
+    void reseed(std::uint64_t seed, std::uint64_t stream = 0) {
+        seedValue = seed;
+        streamValue = stream;
+        spareBegin = spareEnd = 0;
+        std::uint64_t x = seed ^ mix(stream + 0x9E3779B97F4A7C15ull);
+        for (auto& word : s) word = splitmix(x);
+    }
+
+    std::uint64_t getSeed() const { return seedValue; }
+    std::uint64_t getStream() const { return streamValue; }
+
+    // UniformRandomBitGenerator, so <random> distributions work too
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Fills out[0, n) with dice 1..6
+    void rollD6(std::uint8_t* out, std::size_t n) {
+        while (n > 0) {
+            if (spareBegin == spareEnd) refill();
+            std::size_t k = std::min<std::size_t>(n, spareEnd - spareBegin);
+            std::memcpy(out, spare + spareBegin, k);
+            spareBegin += (std::uint8_t)k;
+            out += k;
+            n -= k;
+        }
+    }
+
+private:
+    static constexpr int digitsPerHalf = 10;
+    static constexpr std::uint32_t sixPow[digitsPerHalf + 1] = {
+        1, 6, 36, 216, 1296, 7776, 46656, 279936, 1679616, 10077696, 60466176 };
+    static constexpr std::uint32_t rejectBelow = (std::uint32_t)((1ull << 32) % sixPow[digitsPerHalf]);
+
+    std::uint64_t s[4];
+    std::uint64_t seedValue = 0, streamValue = 0;
+    std::uint8_t spare[2 * digitsPerHalf];
+    std::uint8_t spareBegin = 0, spareEnd = 0;
+
+    void refill() {
+        spareBegin = spareEnd = 0;
+        while (spareEnd == 0) { // both halves rejected: one draw in five million
+            std::uint64_t word = (*this)();
+            decode((std::uint32_t)word);
+            decode((std::uint32_t)(word >> 32));
+        }
+    }
+
+    void decode(std::uint32_t x) {
+        if ((std::uint32_t)(x * sixPow[digitsPerHalf]) < rejectBelow) return;
+        for (int i = 0; i < digitsPerHalf; ++i) {
+            auto frac = (std::uint32_t)(x * sixPow[i]);
+            spare[spareEnd + i] = (std::uint8_t)((((std::uint64_t)frac * 6) >> 32) + 1);
+        }
+        spareEnd += digitsPerHalf;
+    }
+
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    static std::uint64_t splitmix(std::uint64_t& x) { return mix(x += 0x9E3779B97F4A7C15ull); }
+};
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+// Retained-mode HUD: every text node and button is built once. Each
+// setter compares the bound value with the last one it saw and only
+// rebuilds the node's string when something changed, so an idle frame
+// formats and allocates nothing.
+class Hud {
+public:
+    static constexpr unsigned labelSize = 18;
+    static constexpr unsigned titleSize = 20;
+
+    explicit Hud(std::size_t seats);
+
+    // The font must outlive the HUD. Nothing is drawn before it is set.
+    void setFont(const sf::Font& font);
+    bool hasFont() const { return font != nullptr; }
+
+    void addButton(const sf::FloatRect& rect, const std::string& label);
+
+    void setStatus(bool connected, const std::string& phase, const std::string& turn);
+    void setBet(const std::string& better, int count, int face);
+    void setSelection(int count, int face, bool valid);
+    void setSeat(std::size_t seat, const std::string& name, int diceCount, sf::Vector2f position);
+    void hideSeat(std::size_t seat);
+
+    void draw(sf::RenderTarget& target) const;
+
+private:
+    struct Status { bool connected = false; std::string phase, turn; };
+    struct Bet { std::string better; int count = -1, face = -1; };
+    struct Seat {
+        sf::Text text;
+        std::string name;
+        int diceCount = -1;
+        sf::Vector2f position;
+        bool visible = false;
+    };
+
+    const sf::Font* font = nullptr;
+
+    sf::Text statusText, betText, selectionText;
+    Status status;
+    Bet bet;
+    int selCount = -1, selFace = -1;
+    bool selValid = true;
+    std::vector<Seat> seats;
+    std::vector<sf::RectangleShape> buttonRects;
+    std::vector<sf::Text> buttonLabels;
+
+    static void style(sf::Text& text, unsigned size, float x, float y);
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include "ClientSession.h"
+#include "PerudoRules.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct LoadConfig {
+    std::string host = "127.0.0.1";
+    unsigned short port = 54000;
+    std::size_t tableSize = 4;                              // players a table waits for before rolling
+    std::chrono::milliseconds lobbyWait{ 2000 };            // then roll with whoever is there (2+)
+    std::chrono::milliseconds stallTimeout{ 10000 };        // silence after which a bot reconnects
+};
+
+// What a bot is waiting to hear back about
+enum class Command : std::uint8_t { Roll, Bet, Doubt, Next, None };
+constexpr std::size_t commandKinds = 4;
+const char* commandName(Command c);
+
+// Counters for the bots of one worker thread. The counters are read by
+// the reporting thread while the worker runs; latencies are only read
+// after the worker has stopped.
+struct alignas(64) LoadStats {
+    std::atomic<std::uint64_t> games{ 0 };
+    std::atomic<std::uint64_t> messages{ 0 };  // server messages received
+    std::atomic<std::uint64_t> commands{ 0 };  // commands sent
+    std::atomic<std::uint64_t> rejects{ 0 };
+    std::atomic<std::uint64_t> connects{ 0 };
+    std::atomic<std::uint64_t> stalls{ 0 };    // reconnects forced by stallTimeout
+    std::atomic<std::uint64_t> unwatched{ 0 }; // bots retired because the reactor refused their socket
+    std::array<std::vector<std::uint32_t>, commandKinds> latencyUs; // per Command
+};
+
+// One scripted player on one binary-protocol connection. It joins
+// whichever table the server gives it, starts the game when the table is
+// full (or after lobbyWait), bets and doubts on its turn from its own dice
+// and the dice count, and starts the next round when it lost the last
+// one. After the winner is announced it leaves, so its next connect()
+// seats it at a fresh table.
+//
+// Latency is measured from sending a command to receiving the broadcast
+// that shows its effect: Phase Betting for Roll and Next, the matching
+// CurrentBet for Bet, Phase Reveal for Doubt.
+class LoadBot {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Rules = perudo::StandardRules; // what the server plays
+
+    LoadBot(std::string name, const LoadConfig& config, LoadStats& stats);
+
+    bool connect();
+    void disconnect();
+    bool isConnected() const { return session.isConnected(); }
+    sf::TcpSocket& getSocket() { return session.getSocket(); }
+
+    // Handles every waiting message, then acts if it is this bot's move.
+    // Returns false when the bot has left and wants to connect again.
+    bool service(Clock::time_point now);
+
+private:
+    std::string name;
+    const LoadConfig& config;
+    LoadStats& stats;
+    ClientSession session;
+
+    // Table as this bot sees it
+    sf::Uint8 you = proto::NoPlayer;
+    proto::PhaseId phase = proto::PhaseId::Lobby;
+    bool started = false;
+    bool myTurn = false;
+    bool gameOver = false;
+    std::array<sf::Uint8, 256> diceOf{};  // dice count by player id
+    std::vector<sf::Uint8> players;       // ids seen at this table
+    proto::CurrentBet bet;
+    proto::Dice myDice;
+    perudo::FaceCounts myFaces{}; // tallied once per MyDice
+
+    Clock::time_point joinedAt, lastHeard;
+    Command pending = Command::None;
+    Clock::time_point sentAt;
+
+    void reset();
+    void apply(const ServerEvent& e);
+    void answered(Command c);
+    void act(Clock::time_point now);
+    void sendCommand(const ClientCommand& cmd, Command kind);
+
+    perudo::RoundState round() const;
+    double expected(int face) const; // dice showing `face` on the whole table, on average
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Perudo rules as pure functions, shared by the server, the client, bots
+// and simulators. Nothing here knows about sockets, names or maps: a round
+// is described by the standing bid and the dice count of the player to act.
+//
+// House rules are template parameters, so each variant compiles to its own
+// straight-line code and the per-die hot path never tests configuration at
+// run time:
+//
+//   OnesWild       ones count towards every other face
+//   OpenOnOnes     the opening bid of a round may be on ones
+//   Palifico       a player down to one die plays a palifico round: ones
+//                  are not wild, may not be bid, and the face is locked
+//   DicePerPlayer  dice each player starts with
+namespace perudo {
+
+template <bool OnesWild = true, bool OpenOnOnes = false, bool Palifico = true, int DicePerPlayer = 5>
+struct Rules {
+    static constexpr bool onesWild = OnesWild;
+    static constexpr bool openOnOnes = OpenOnOnes;
+    static constexpr bool palifico = Palifico;
+    static constexpr int dicePerPlayer = DicePerPlayer;
+};
+
+// The rules PerudoServer has always played
+using StandardRules = Rules<>;
+
+struct Bid {
+    std::uint8_t count = 0; // 0 = no bid yet this round
+    std::uint8_t face = 0;  // 1..6
+};
+
+struct RoundState {
+    Bid bid;                    // standing bid
+    std::uint8_t turnDice = 0;  // dice held by the player to act
+};
+
+template <class R>
+constexpr bool isPalifico(const RoundState& round) {
+    if constexpr (R::palifico) return round.turnDice == 1;
+    else return false;
+}
+
+// True if `die` counts towards a bid on `face`
+template <class R>
+constexpr bool matches(std::uint8_t die, std::uint8_t face, bool palifico) {
+    if constexpr (R::onesWild) return die == face || (die == 1 && face != 1 && !palifico);
+    else return die == face;
+}
+
+// Dice in [first, last) that count towards a bid on `face`
+template <class R, class It>
+constexpr int countMatching(It first, It last, std::uint8_t face, bool palifico) {
+    int total = 0;
+    for (; first != last; ++first) total += matches<R>((std::uint8_t)*first, face, palifico) ? 1 : 0;
+    return total;
+}
+
+// How many dice show each face, index 1..6 (0 collects invalid values).
+// Tallied once per roll, it answers any count below in constant time.
+using FaceCounts = std::array<std::uint32_t, 7>;
+
+template <class It>
+constexpr FaceCounts tallyFaces(It first, It last) {
+    FaceCounts counts{};
+    for (; first != last; ++first) {
+        auto d = (std::uint8_t)*first;
+        ++counts[d <= 6 ? d : 0];
+    }
+    return counts;
+}
+
+// Tallied dice that count towards a bid on `face`
+template <class R>
+constexpr int countMatching(const FaceCounts& counts, std::uint8_t face, bool palifico) {
+    if (face < 1 || face > 6) return 0;
+    return (int)(counts[face] + (face != 1 && matches<R>(1, face, palifico) ? counts[1] : 0));
+}
+
+// May the player to act replace round.bid with `next`?
+template <class R>
+constexpr bool isValidRaise(const RoundState& round, Bid next) {
+    if (next.face < 1 || next.face > 6 || next.count == 0) return false;
+    const Bid cur = round.bid;
+
+    if (isPalifico<R>(round)) {
+        // Ones are not wild and cannot be bid; the face is locked once opened
+        if (next.face == 1) return false;
+        if (cur.count == 0) return true;
+        if (next.face != cur.face) return false;
+        return next.count > cur.count;
+    }
+
+    if (cur.count == 0) return R::openOnOnes || next.face != 1;
+
+    if constexpr (!R::onesWild) {
+        // Ones are an ordinary face: more dice, or as many on a higher face
+        return next.count > cur.count || (next.count == cur.count && next.face > cur.face);
+    }
+    else {
+        if (cur.face != 1 && next.face != 1)  // more dice, or as many on a higher face
+            return next.count > cur.count || (next.count == cur.count && next.face > cur.face);
+        if (cur.face != 1)                    // onto ones: at least half, rounded up
+            return next.count >= (cur.count + 1) / 2;
+        if (next.face == 1)                   // ones to ones: more of them
+            return next.count > cur.count;
+        return next.count >= 2 * cur.count + 1; // off ones: double plus one
+    }
+}
+
+// Does the bid stand once `matching` dice are known to count towards it?
+constexpr bool bidHolds(Bid bid, int matching) {
+    return matching >= bid.count;
+}
+
+}
@@ -0,0 +1,239 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Binary wire protocol shared by PerudoGame and PerudoServer.
+//
+// Every message is one sf::Packet: a one-byte opcode followed by the
+// message's fields, in the order listed by its `fields` function. That
+// function is the whole schema: the same list drives encode() and
+// decode(), so client and server cannot disagree about a layout.
+//
+// Field encodings: Uint8 is one byte, Uint16 two bytes big-endian;
+// strings, dice lists and nested message lists are a one-byte count
+// followed by the elements. Players are named once (Snapshot or Player)
+// and referred to by their per-table id afterwards.
+//
+// State sync: on joining, a client receives one Snapshot of the whole
+// table. Every later change of shared table state is a small delta
+// (Player, DiceCount, Phase, Turn, CurrentBet, Reveal, Info) carrying
+// the table's next sequence number. A Player delta with an empty name
+// means that player left and the seat is gone. A client that sees a gap in the
+// sequence stops applying deltas and sends Resync; the server answers
+// with a fresh Snapshot. Private replies (MyDice, Reject) are not part
+// of the shared state and carry no sequence number.
+//
+// Negotiation: a client sends "PROTO <highest version>" as a text line
+// before HELLO. A server that understands it replies "PROTO <version>"
+// (still text) and uses binary messages from then on; older servers
+// ignore the line and the client keeps talking text. A client offering
+// an older binary version than the server's is answered "PROTO 0" and
+// stays on text. Text packets always begin with a zero byte (the high
+// byte of the string length), which is why opcode 0 is never used.
+namespace proto {
+
+constexpr sf::Uint8 Version = 2;
+constexpr sf::Uint8 NoPlayer = 0xFF;
+
+enum class Op : sf::Uint8 {
+    // client -> server
+    Roll = 1, Bet, Doubt, Next, Resync,
+    // server -> client
+    Snapshot = 16, Player, DiceCount, Phase, Turn, CurrentBet, Reveal, MyDice, Info, Reject
+};
+
+enum class PhaseId : sf::Uint8 { Lobby, Betting, Reveal };
+enum class InfoId : sf::Uint8 { LostDie, Eliminated, Winner };
+enum class RejectId : sf::Uint8 { NotYourTurn, InvalidBet };
+
+using Dice = std::vector<sf::Uint8>;
+using Seq = sf::Uint16; // wraps; only ever compared for equality
+
+// ---- Schema ----
+struct Roll  { static constexpr Op op = Op::Roll;  template <class M, class F> static void fields(M&, F&&) {} };
+struct Doubt { static constexpr Op op = Op::Doubt; template <class M, class F> static void fields(M&, F&&) {} };
+struct Next  { static constexpr Op op = Op::Next;  template <class M, class F> static void fields(M&, F&&) {} };
+struct Resync { static constexpr Op op = Op::Resync; template <class M, class F> static void fields(M&, F&&) {} };
+
+struct Bet {
+    static constexpr Op op = Op::Bet;
+    sf::Uint8 count = 0, face = 0;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.count); f(m.face); }
+};
+
+// One seat inside a Snapshot
+struct SeatState {
+    sf::Uint8 player = NoPlayer;
+    std::string name;
+    sf::Uint8 diceCount = 0;
+    Dice revealed; // only during the reveal phase
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.player); f(m.name); f(m.diceCount); f(m.revealed); }
+};
+
+// Whole table as seen by the receiving connection, as of sequence `seq`
+struct Snapshot {
+    static constexpr Op op = Op::Snapshot;
+    Seq seq = 0;
+    sf::Uint8 you = NoPlayer;
+    PhaseId phase = PhaseId::Lobby;
+    sf::Uint8 turn = NoPlayer;
+    sf::Uint8 better = NoPlayer, count = 0, face = 0;
+    std::vector<SeatState> seats;
+    Dice myDice;
+    template <class M, class F> static void fields(M& m, F&& f) {
+        f(m.seq); f(m.you); f(m.phase); f(m.turn);
+        f(m.better); f(m.count); f(m.face); f(m.seats); f(m.myDice);
+    }
+};
+
+// ---- Deltas: `seq` is filled in by the table when it publishes them ----
+// Joined (or renamed), or left when `name` is empty
+struct Player {
+    static constexpr Op op = Op::Player;
+    Seq seq = 0;
+    sf::Uint8 player = NoPlayer;
+    std::string name;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.seq); f(m.player); f(m.name); }
+};
+
+struct DiceCount {
+    static constexpr Op op = Op::DiceCount;
+    Seq seq = 0;
+    sf::Uint8 player = NoPlayer, count = 0;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.seq); f(m.player); f(m.count); }
+};
+
+struct Phase {
+    static constexpr Op op = Op::Phase;
+    Seq seq = 0;
+    PhaseId phase = PhaseId::Lobby;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.seq); f(m.phase); }
+};
+
+struct Turn {
+    static constexpr Op op = Op::Turn;
+    Seq seq = 0;
+    sf::Uint8 player = NoPlayer;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.seq); f(m.player); }
+};
+
+struct CurrentBet {
+    static constexpr Op op = Op::CurrentBet;
+    Seq seq = 0;
+    sf::Uint8 player = NoPlayer, count = 0, face = 0; // NoPlayer = no bet yet
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.seq); f(m.player); f(m.count); f(m.face); }
+};
+
+struct Reveal {
+    static constexpr Op op = Op::Reveal;
+    Seq seq = 0;
+    sf::Uint8 player = NoPlayer;
+    Dice dice;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.seq); f(m.player); f(m.dice); }
+};
+
+struct MyDice {
+    static constexpr Op op = Op::MyDice;
+    Dice dice;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.dice); }
+};
+
+struct Info {
+    static constexpr Op op = Op::Info;
+    Seq seq = 0;
+    InfoId info = InfoId::LostDie;
+    sf::Uint8 player = NoPlayer, value = 0;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.seq); f(m.info); f(m.player); f(m.value); }
+};
+
+// ---- Private replies ----
+struct Reject {
+    static constexpr Op op = Op::Reject;
+    RejectId reason = RejectId::NotYourTurn;
+    template <class M, class F> static void fields(M& m, F&& f) { f(m.reason); }
+};
+
+// ---- Codec ----
+struct Writer {
+    sf::Packet& out;
+    void operator()(sf::Uint8 v) { out.append(&v, 1); }
+    void operator()(sf::Uint16 v) { (*this)((sf::Uint8)(v >> 8)); (*this)((sf::Uint8)v); }
+    template <class E, class = std::enable_if_t<std::is_enum<E>::value>>
+    void operator()(E e) { (*this)(static_cast<sf::Uint8>(e)); }
+    void operator()(const std::string& s) { bytes(s.data(), s.size()); }
+    void operator()(const Dice& d) { bytes(d.data(), d.size()); }
+    template <class T> void operator()(const std::vector<T>& list) {
+        sf::Uint8 n = (sf::Uint8)std::min<std::size_t>(list.size(), 255);
+        (*this)(n);
+        for (sf::Uint8 i = 0; i < n; ++i) T::fields(list[i], *this);
+    }
+    void bytes(const void* data, std::size_t size) {
+        sf::Uint8 n = (sf::Uint8)std::min<std::size_t>(size, 255);
+        out.append(&n, 1);
+        out.append(data, n);
+    }
+};
+
+struct Reader {
+    const sf::Uint8* cur;
+    const sf::Uint8* end;
+    bool ok = true;
+
+    void operator()(sf::Uint8& v) {
+        if (cur >= end) { ok = false; return; }
+        v = *cur++;
+    }
+    void operator()(sf::Uint16& v) {
+        sf::Uint8 hi = 0, lo = 0; (*this)(hi); (*this)(lo);
+        v = (sf::Uint16)((hi << 8) | lo);
+    }
+    template <class E, class = std::enable_if_t<std::is_enum<E>::value>>
+    void operator()(E& e) {
+        sf::Uint8 v = 0; (*this)(v); e = static_cast<E>(v);
+    }
+    void operator()(std::string& s) {
+        sf::Uint8 n = 0; (*this)(n);
+        if (!ok || end - cur < n) { ok = false; return; }
+        s.assign(reinterpret_cast<const char*>(cur), n); cur += n;
+    }
+    void operator()(Dice& d) {
+        sf::Uint8 n = 0; (*this)(n);
+        if (!ok || end - cur < n) { ok = false; return; }
+        d.assign(cur, cur + n); cur += n;
+    }
+    template <class T> void operator()(std::vector<T>& list) {
+        sf::Uint8 n = 0; (*this)(n);
+        list.assign(ok ? n : 0, T{});
+        for (auto& item : list) T::fields(item, *this);
+    }
+};
+
+template <class Msg>
+void encode(const Msg& msg, sf::Packet& out) {
+    out.clear();
+    sf::Uint8 op = static_cast<sf::Uint8>(Msg::op);
+    out.append(&op, 1);
+    Msg::fields(msg, Writer{ out });
+}
+
+// Decodes the fields of a packet whose opcode is Msg::op.
+template <class Msg>
+bool decode(const sf::Packet& in, Msg& msg) {
+    auto* data = static_cast<const sf::Uint8*>(in.getData());
+    Reader r{ data + 1, data + in.getDataSize() };
+    Msg::fields(msg, r);
+    return r.ok;
+}
+
+inline bool isBinary(const sf::Packet& p) {
+    return p.getDataSize() > 0 && *static_cast<const sf::Uint8*>(p.getData()) != 0;
+}
+
+inline Op opcode(const sf::Packet& p) {
+    return static_cast<Op>(*static_cast<const sf::Uint8*>(p.getData()));
+}
+
+} // namespace proto
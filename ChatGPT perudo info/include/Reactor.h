@@ -0,0 +1,39 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include <memory>
+#include <vector>
+
+// Reactor waits for socket readiness and reports only the sockets that
+// have work, so a wakeup costs O(ready) instead of O(connections).
+class Reactor {
+public:
+    enum : unsigned { Readable = 1u << 0, Writable = 1u << 1 };
+
+    struct Ready {
+        void* token;      // value given to add()
+        unsigned events;  // Readable / Writable
+    };
+
+    // Writable is only reported by backends that can watch for it (epoll).
+    // With the others, callers retry queued output on every wakeup.
+    virtual bool reportsWritable() const = 0;
+
+    virtual ~Reactor() = default;
+
+    virtual bool add(sf::Socket& socket, void* token) = 0;
+    virtual void remove(sf::Socket& socket) = 0;
+
+    // Blocks until a registered socket is ready or timeoutMs elapses
+    // (timeoutMs < 0 waits forever). `ready` is overwritten.
+    virtual void wait(int timeoutMs, std::vector<Ready>& ready) = 0;
+
+    // Interrupts a wait() in progress from any thread.
+    virtual void wake() = 0;
+
+    // Edge-triggered backends report a socket once per readiness change,
+    // so callers always drain a ready socket until it returns NotReady.
+    virtual bool edgeTriggered() const = 0;
+
+    // epoll on Linux, sf::SocketSelector everywhere else.
+    static std::unique_ptr<Reactor> create();
+};
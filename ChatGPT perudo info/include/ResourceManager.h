@@ -1,32 +1,54 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include "AssetPack.h"
+#include "TextureCache.h"
 #include <map>
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
 #include <iostream>
 
+// A named sub-rectangle of a shared texture
+struct AtlasRegion {
+    const sf::Texture* texture = nullptr;
+    sf::IntRect rect;
+};
+
+// An atlas laid out in memory but not yet on the GPU
+struct PackedAtlas {
+    sf::Image sheet;
+    std::map<std::string, sf::IntRect> rects;
+};
+
 class ResourceManager {
 public:
-    static sf::Texture& getTexture(const std::string& filename) {
-        // If texture is already loaded, return it
-        auto it = textures.find(filename);
-        if (it != textures.end()) {
-            return *it->second;
-        }
-
-        // Otherwise, load it
-        auto texture = std::make_unique<sf::Texture>();
-        if (!texture->loadFromFile(filename)) {
-            std::cerr << "Error: could not load texture " << filename << std::endl;
-            static sf::Texture dummy; // fallback
-            return dummy;
-        }
-
-        sf::Texture& ref = *texture;
-        textures[filename] = std::move(texture);
-        return ref;
+    // Packs the given images (region name -> file) into one atlas texture.
+    // Call once at startup; regions of an earlier atlas become invalid.
+    static void buildAtlas(const std::vector<std::pair<std::string, std::string>>& files);
+
+    // The two halves of buildAtlas. packAtlas only decodes and copies
+    // pixels, so it may run on any thread; installAtlas takes a texture
+    // already holding the sheet and must run on the render thread.
+    // Files found in `pack` are read from it instead of from disk.
+    static PackedAtlas packAtlas(const std::vector<std::pair<std::string, std::string>>& files, const AssetPack* pack = nullptr);
+    static bool loadImage(sf::Image& image, const std::string& filename, const AssetPack* pack);
+    static void installAtlas(std::unique_ptr<sf::Texture> texture, const std::map<std::string, sf::IntRect>& rects);
+
+    // Where `name` lives in the atlas
+    static const AtlasRegion& getRegion(const std::string& name);
+
+    // Loose textures outside the atlas, e.g. theme art. The handle keeps
+    // the texture loaded; an empty handle means the file failed to load.
+    static TextureHandle getTexture(const std::string& filename) {
+        return textures.get(filename);
     }
 
+    // Budget and hit/miss/eviction counters of the loose textures
+    static TextureCache& getTextureCache() { return textures; }
+
 private:
-    static std::map<std::string, std::unique_ptr<sf::Texture>> textures;
+    static TextureCache textures;
+    static std::unique_ptr<sf::Texture> atlas;
+    static std::map<std::string, AtlasRegion> regions;
 };
\ No newline at end of file
@@ -1,17 +1,83 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <map>
+#include <tuple>
 #include <vector>
 
+// Points evenly spaced on a unit circle, starting at the top (-90 degrees)
+// and going clockwise on screen. Tables for 1..maxPoints points are built
+// at compile time; the trig is a Taylor series since std::cos is not
+// constexpr.
+namespace unit_circle {
+constexpr int maxPoints = 8;
+constexpr double pi = 3.14159265358979323846;
+
+struct Point { float x, y; };
+
+constexpr double sinTaylor(double a) {
+    while (a > pi) a -= 2 * pi;   // reduce to [-pi, pi]
+    while (a < -pi) a += 2 * pi;
+    double term = a, sum = a;
+    for (int k = 1; k < 12; ++k) {
+        term *= -a * a / ((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+constexpr double cosTaylor(double a) { return sinTaylor(a + pi / 2); }
+
+struct Tables { Point points[maxPoints + 1][maxPoints]; }; // [count][index]
+
+constexpr Tables build() {
+    Tables t{};
+    for (int n = 1; n <= maxPoints; ++n) {
+        for (int i = 0; i < n; ++i) {
+            double angle = i * (2 * pi / n) - pi / 2;
+            t.points[n][i] = { (float)cosTaylor(angle), (float)sinTaylor(angle) };
+        }
+    }
+    return t;
+}
+constexpr Tables tables = build();
+
+// Falls back to runtime trig above maxPoints
+Point at(int index, int count);
+}
+
+// Every position the table view needs for one combination of player
+// count, dice per player and window size.
+struct SeatLayout {
+    int players = 0;
+    int dice = 0;
+    std::vector<sf::Vector2f> seats; // 0 = you (bottom centre), then opponents clockwise
+
+    // Centre of die `index` when `count` dice are laid out around `seat`
+    sf::Vector2f die(int seat, int index, int count) const {
+        return diceSpots[((std::size_t)seat * dice + (count - 1)) * dice + index];
+    }
+
+    std::vector<sf::Vector2f> diceSpots; // [seat][count - 1][index]
+};
+
 // SeatManager is responsible for calculating positions
 // of players (your dice at bottom, others with cups).
 class SeatManager {
 public:
+    static constexpr float myDiceRadius = 90.f;
+    static constexpr float opponentDiceRadius = 60.f;
+
     SeatManager(float windowWidth, float windowHeight);
 
-    // Get seat position for a given player index
-    sf::Vector2f getSeatPosition(int playerIndex, int totalPlayers);
+    // Drops every cached layout if the size actually changed
+    void setWindowSize(float windowWidth, float windowHeight);
+
+    // Computed once per (players, dice, window size) and reused until a resize
+    const SeatLayout& layout(int totalPlayers, int dicePerPlayer);
 
 private:
     float winW;
     float winH;
+    std::map<std::tuple<int, int>, SeatLayout> layouts; // (players, dice) at winW x winH
+
+    sf::Vector2f computeSeat(int playerIndex, int totalPlayers) const;
 };
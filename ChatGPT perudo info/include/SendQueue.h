@@ -0,0 +1,65 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// An immutable message already in sf::Packet wire framing (u32 big-endian
+// size, then data). A broadcast builds one Frame and every recipient's
+// queue holds a reference to it, so fan-out costs one serialization plus
+// one pointer push per seat.
+using Frame = std::shared_ptr<const std::vector<char>>;
+
+inline Frame makeFrame(const sf::Packet& packet) {
+    auto size = (sf::Uint32)packet.getDataSize();
+    auto bytes = std::make_shared<std::vector<char>>(4 + size);
+    (*bytes)[0] = (char)(size >> 24); (*bytes)[1] = (char)(size >> 16);
+    (*bytes)[2] = (char)(size >> 8);  (*bytes)[3] = (char)size;
+    if (size) std::copy_n(static_cast<const char*>(packet.getData()), size, bytes->data() + 4);
+    return bytes;
+}
+
+// A connection's send queue: frames waiting for the socket, the front one
+// possibly partly written already.
+class SendQueue {
+public:
+    std::size_t size() const { return bytes; } // unsent bytes
+    bool empty() const { return bytes == 0; }
+
+    void push(Frame frame) {
+        bytes += frame->size();
+        frames.push_back(std::move(frame));
+    }
+
+    // Up to maxSpans contiguous spans of unsent bytes, oldest first, ready
+    // for a gathering write. Returns the number filled in.
+    int spans(const char* ptr[], std::size_t len[], int maxSpans) const {
+        int n = 0;
+        std::size_t skip = frontOffset;
+        for (auto it = frames.begin(); it != frames.end() && n < maxSpans; ++it, ++n) {
+            ptr[n] = (*it)->data() + skip;
+            len[n] = (*it)->size() - skip;
+            skip = 0;
+        }
+        return n;
+    }
+
+    void consume(std::size_t n) {
+        n = std::min(n, bytes);
+        bytes -= n;
+        while (n > 0) {
+            std::size_t left = frames.front()->size() - frontOffset;
+            if (n < left) { frontOffset += n; return; }
+            n -= left;
+            frames.pop_front();
+            frontOffset = 0;
+        }
+    }
+
+private:
+    std::deque<Frame> frames;
+    std::size_t frontOffset = 0;
+    std::size_t bytes = 0;
+};
@@ -1,73 +1,43 @@
 #pragma once
 #include <SFML/Network.hpp>
-#include <map>
+#include "Shard.h"
+#include <thread>
 #include <vector>
 #include <memory>
 #include <string>
 
+// Server accepts connections and hands them to Shards, which run one
+// thread per core and own their tables outright. Consecutive connections
+// go to the same shard a table's worth at a time so that people joining
+// together end up at the same table; then the least-loaded shard is next.
 class Server {
 public:
-    struct PlayerInfo {
-        sf::TcpSocket* sock = nullptr;
-        std::string name;
-        int diceCount = 5;
-        bool connected = false;
-    };
+    // threads == 0 uses one shard per hardware thread
+    bool start(unsigned short port, unsigned threads = 0);
 
-    enum class Phase { Lobby, Betting, Reveal };
+    // Logs connections with queued output every `seconds` (0 = never).
+    // Call before start().
+    void setStatsInterval(unsigned seconds) { statsInterval = seconds; }
 
-    bool start(unsigned short port);
+    // Seed for every table's dice; table N rolls stream N of it. Call
+    // before start().
+    void setDiceSeed(std::uint64_t seed) { diceSeed = seed; }
 
-private:
-    // Networking
-    sf::TcpListener listener;
-    sf::SocketSelector selector;
-    std::vector<std::unique_ptr<sf::TcpSocket>> clients;
-
-    // Game state
-    std::map<sf::TcpSocket*, PlayerInfo> playersBySock;
-    std::map<std::string, std::vector<int>> roundDice; // name -> dice
-    std::vector<sf::TcpSocket*> turnOrder;
-    int turnIndex = 0;
-
-    Phase phase = Phase::Lobby;
-
-    // Current bet
-    std::string currentBetter;
-    int currentBetCount = 0;
-    int currentBetFace = 0; // 1..6
-
-    // Round starters
-    std::string firstRoundStarter;  // who pressed R first
-    std::string lastRoundLoser;     // who lost a die last round (starts next)
+    // Send-queue depth of every connection, gathered from all shards.
+    std::vector<Shard::QueueStat> queueStats();
 
-    // ---- Internals ----
-    void handleNewConnection();
-    bool handleClientMessage(sf::TcpSocket* client);
-
-    void sendLine(sf::TcpSocket* client, const std::string& line);
-    void broadcast(const std::string& line);
-
-    std::string nameOf(sf::TcpSocket* s) const;
-    PlayerInfo* getPlayerByName(const std::string& name);
-
-    void setupTurnOrderIfNeeded();
-    void startBettingIfPossible();
-    void advanceTurn();
-
-    void broadcastPlayerDiceCounts();
-    void broadcastTurn();
-    void broadcastCurrentBet();
-    void broadcastRevealAll();
+private:
+    static constexpr std::size_t seatsPerTable = 8;
 
-    void rollAllDice();
-    void sendPrivateDiceToOwners(); // sends "MYDICE ..." to each owner
+    sf::TcpListener listener;
+    std::vector<std::unique_ptr<Shard>> shards;
+    Shard* filling = nullptr;   // shard receiving new connections
+    std::size_t fillCount = 0;  // connections sent to it so far
 
-    // Rules / helpers
-    bool isValidRaise(int newCount, int newFace) const;
-    int  countMatching(const std::map<std::string, std::vector<int>>& allDice, int betFace) const;
-    bool isPalificoRound() const; // true if the player whose turn it is has exactly 1 die
+    unsigned statsInterval = 0;
+    std::uint64_t diceSeed = 0;
+    std::thread monitor;
 
-    void resolveDoubt(sf::TcpSocket* challenger);
-    void beginNextRound();
+    Shard& leastLoaded();
+    void reportQueues();
 };
@@ -0,0 +1,103 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include "Connection.h"
+#include "Reactor.h"
+#include "TableManager.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// A Shard is one worker thread that owns a set of tables together with
+// the sockets of everyone seated at them. All game and socket work on the
+// hot path is shard-local; other threads only talk to a shard through its
+// inbox (new connections, stolen tables, steal requests, stats requests).
+class Shard {
+public:
+    // Send-queue depth of one connection, for monitoring.
+    struct QueueStat {
+        int shard = 0;
+        int table = 0;          // 0 = not seated yet
+        std::string player;
+        std::size_t queued = 0; // bytes waiting for the socket
+        std::size_t peak = 0;
+    };
+
+    Shard(int index, int shardCount, std::size_t seatsPerTable, std::uint64_t diceSeed);
+    ~Shard();
+
+    void setPeers(const std::vector<Shard*>& all) { peers = all; }
+    void start();
+
+    // Called by the accept thread.
+    void adopt(std::unique_ptr<sf::TcpSocket> socket);
+
+    // Connections owned (or on their way to) this shard.
+    std::size_t load() const { return connectionCount.load(std::memory_order_relaxed); }
+
+    // Answered by the shard thread on its next wakeup; safe from any thread.
+    std::future<std::vector<QueueStat>> requestQueueStats();
+
+private:
+    // A whole table moving between shards, sockets included.
+    struct TableTransfer {
+        std::unique_ptr<Table> table;
+        std::vector<std::unique_ptr<Connection>> seated;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    int index;
+    std::unique_ptr<Reactor> reactor;
+    std::unordered_map<Connection*, std::unique_ptr<Connection>> clients;
+    std::vector<Connection*> closed;               // dropped at the end of the loop turn
+    std::unordered_set<Connection*> backlogged;    // send queue not empty
+    TableManager tables;
+    std::vector<Shard*> peers;
+    std::thread thread;
+
+    std::atomic<std::size_t> connectionCount{ 0 };
+    std::atomic<bool> stealPending{ false };
+    Clock::time_point nextBalance;          // next periodic shedLoad()
+
+    // Cross-thread handoffs; the only state guarded by a lock
+    std::mutex inboxMutex;
+    std::vector<std::unique_ptr<Connection>> inboxConnections;
+    std::vector<TableTransfer> inboxTables;
+    std::vector<Shard*> inboxStealRequests;
+    std::vector<std::promise<std::vector<QueueStat>>> inboxStatsRequests;
+
+    // ---- Internals ----
+    void run();
+    void drainInbox();
+    void watch(std::unique_ptr<Connection> conn);
+
+    void serviceClient(Connection* client);       // read, handle, flush replies
+    bool handleClientMessages(Connection* client); // false once the peer is gone
+    bool handleClientMessage(Connection* client, sf::Packet& p);
+    bool handleBinaryMessage(Connection* client, sf::Packet& p);
+    void flushTable(Connection* client);
+    void flushConnection(Connection* client);
+    void flushBacklog();
+    int msUntilNextTimer() const;           // -1 when nothing is due
+    bool balancing() const;                 // whether the balance tick runs
+    std::vector<QueueStat> queueStats() const;
+    void markClosed(Connection* client);
+    void dropClosed();
+    void dropClient(Connection* client);
+
+    // Work stealing: an underloaded shard asks the busiest peer for tables
+    // whenever it drops connections, and on every balance tick a shard with
+    // tables hands some to its lightest peer
+    void maybeSteal();
+    void shedLoad();
+    void giveTablesTo(Shard* thief);
+    void post(TableTransfer transfer);
+    void post(Shard* thief);
+};
@@ -0,0 +1,179 @@
+#pragma once
+#include "PerudoRules.h"
+#include "DicePool.h"
+#include "DiceRng.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// In-process Perudo games for tuning house rules and strategies offline.
+// A game follows the server's flow: the first seat opens the first round,
+// the loser of each doubt opens the next (or the next live seat if that
+// doubt eliminated them), and the player to act decides palifico. Bids and
+// doubts are judged by perudo_rules, exactly as Table does.
+//
+// Every seat plays the same strategy: estimate how many dice show each
+// face (own dice plus the odds for the unseen ones), doubt a bid more than
+// `doubtMargin` above that estimate, otherwise bid up to the estimate on
+// the strongest face the rules allow.
+namespace sim {
+
+constexpr int maxSeats = 8;
+
+struct SimConfig {
+    int players = 4;
+    double doubtMargin = 1.0;
+};
+
+// Summable, so chunks can run on any thread in any order
+struct SimStats {
+    std::uint64_t games = 0;
+    std::uint64_t rounds = 0;
+    std::uint64_t bids = 0;
+    std::uint64_t onesBids = 0;
+    std::uint64_t doubts = 0;
+    std::uint64_t bidsHeld = 0;       // doubts the bidder won
+    std::uint64_t exactBids = 0;      // doubted bids that were exactly right
+    std::uint64_t palificoDoubts = 0;
+    std::uint64_t minRounds = UINT64_MAX, maxRounds = 0; // per game
+    std::array<std::uint64_t, maxSeats> wins{};
+
+    void merge(const SimStats& o) {
+        games += o.games; rounds += o.rounds; bids += o.bids; onesBids += o.onesBids;
+        doubts += o.doubts; bidsHeld += o.bidsHeld; exactBids += o.exactBids; palificoDoubts += o.palificoDoubts;
+        minRounds = std::min(minRounds, o.minRounds);
+        maxRounds = std::max(maxRounds, o.maxRounds);
+        for (int i = 0; i < maxSeats; ++i) wins[i] += o.wins[i];
+    }
+};
+
+template <class R>
+class SimGame {
+public:
+    static constexpr int dicePerPlayer = R::dicePerPlayer;
+
+    explicit SimGame(const SimConfig& config)
+        : players(std::clamp(config.players, 2, maxSeats)), margin(config.doubtMargin) {
+    }
+
+    // Plays one game to the end and returns the winning seat
+    int play(perudo::DiceRng& rng, SimStats& stats) {
+        diceCount.fill(0);
+        for (int p = 0; p < players; ++p) diceCount[p] = dicePerPlayer;
+        totalDice = players * dicePerPlayer;
+        int alive = players;
+        int opener = 0;
+        std::uint64_t rounds = 0;
+
+        while (alive > 1) {
+            pool.clear();
+            for (int p = 0; p < players; ++p) {
+                if (diceCount[p] == 0) continue;
+                handOf[p] = pool.getHands().size();
+                pool.add((std::uint8_t)p, (std::size_t)diceCount[p]);
+            }
+            rng.rollD6(pool.data(), pool.size());
+            pool.tally();
+            ++rounds;
+
+            perudo::RoundState round;
+            int seat = opener, better = -1;
+            for (;;) {
+                round.turnDice = (std::uint8_t)diceCount[seat];
+                perudo::Bid bid;
+                if (better < 0 || !doubts(seat, round)) bid = choose(seat, round);
+                if (bid.count == 0) {
+                    // Doubt: the player to act settles palifico, as on the server
+                    bool palifico = perudo::isPalifico<R>(round);
+                    int matching = perudo::countMatching<R>(pool, round.bid.face, palifico);
+                    bool held = perudo::bidHolds(round.bid, matching);
+                    ++stats.doubts;
+                    stats.bidsHeld += held;
+                    stats.exactBids += matching == round.bid.count;
+                    stats.palificoDoubts += palifico;
+
+                    int loser = held ? seat : better;
+                    --diceCount[loser];
+                    --totalDice;
+                    if (diceCount[loser] == 0) --alive;
+                    opener = diceCount[loser] > 0 ? loser : nextAlive(loser);
+                    break;
+                }
+                round.bid = bid;
+                better = seat;
+                ++stats.bids;
+                stats.onesBids += bid.face == 1;
+                seat = nextAlive(seat);
+            }
+        }
+
+        int winner = nextAlive(players - 1);
+        ++stats.games;
+        stats.rounds += rounds;
+        stats.minRounds = std::min(stats.minRounds, rounds);
+        stats.maxRounds = std::max(stats.maxRounds, rounds);
+        ++stats.wins[winner];
+        return winner;
+    }
+
+private:
+    int players;
+    double margin;
+    std::array<int, maxSeats> diceCount{};
+    perudo::DicePool pool;                // this round's dice
+    std::array<std::size_t, maxSeats> handOf{}; // seat -> its hand in pool (live seats only)
+    int totalDice = 0;
+
+    int nextAlive(int seat) const {
+        for (int k = 1; k <= players; ++k) {
+            int s = (seat + k) % players;
+            if (diceCount[s] > 0) return s;
+        }
+        return seat;
+    }
+
+    int countOwn(int seat, std::uint8_t face, bool palifico) const {
+        return perudo::countMatching<R>(pool.getHands()[handOf[seat]].faces, face, palifico);
+    }
+
+    double expected(int seat, std::uint8_t face, bool palifico) const {
+        double chance = perudo::matches<R>(1, face, palifico) ? 2.0 / 6.0 : 1.0 / 6.0;
+        return countOwn(seat, face, palifico) + (totalDice - diceCount[seat]) * chance;
+    }
+
+    bool doubts(int seat, const perudo::RoundState& round) const {
+        return round.bid.count > expected(seat, round.bid.face, perudo::isPalifico<R>(round)) + margin;
+    }
+
+    // Best valid bid, or count 0 when there is none (only possible over a
+    // standing bid). On each face the bid goes up to the expected count;
+    // the face expected most often wins, unless every face is already
+    // past its estimate, in which case the smallest overbid wins.
+    perudo::Bid choose(int seat, const perudo::RoundState& round) const {
+        bool palifico = perudo::isPalifico<R>(round);
+        perudo::Bid best;
+        double bestScore = -1e9;
+        // Every legal raise is at least half the standing count, and none
+        // needs more than double plus one
+        int from = std::max(1, (round.bid.count + 1) / 2);
+        int to = std::max(from, 2 * round.bid.count + 1);
+        for (int f = 1; f <= 6; ++f) {
+            int lowest = 0;
+            for (int c = from; c <= to && c <= 255; ++c) {
+                if (perudo::isValidRaise<R>(round, { (std::uint8_t)c, (std::uint8_t)f })) { lowest = c; break; }
+            }
+            if (lowest == 0) continue;
+
+            double e = expected(seat, (std::uint8_t)f, palifico);
+            int count = std::min(std::max(lowest, (int)e), 255);
+            double score = count <= e ? e : e - count - 1000.0;
+            if (score > bestScore) {
+                bestScore = score;
+                best = { (std::uint8_t)count, (std::uint8_t)f };
+            }
+        }
+        return best;
+    }
+};
+
+}
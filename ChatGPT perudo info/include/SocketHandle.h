@@ -0,0 +1,10 @@
+#pragma once
+#include <SFML/Network.hpp>
+
+// sf::Socket::getHandle() is protected; naming it through a derived class
+// gives the reactor and the send path the native handle of any SFML socket.
+struct SocketHandleAccess : sf::Socket {
+    static sf::SocketHandle of(const sf::Socket& s) {
+        return (s.*(&SocketHandleAccess::getHandle))();
+    }
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Head and tail only ever grow; the slot is index & mask. Each
+// side writes only its own counter, so a push or pop is one acquire load
+// and one release store, and the two never share a cache line.
+template <class T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : slots(roundUp(capacity)), mask(slots.size() - 1) {}
+
+    // Producer side. Leaves `value` untouched and returns false when full.
+    bool push(T&& value) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) return false;
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when empty.
+    bool pop(T& out) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        out = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool empty() const {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static std::size_t roundUp(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    std::vector<T> slots;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head{ 0 }; // next slot to pop
+    alignas(64) std::atomic<std::size_t> tail{ 0 }; // next slot to push
+};
@@ -0,0 +1,106 @@
+#pragma once
+#include "Connection.h"
+#include "Protocol.h"
+#include "PerudoRules.h"
+#include "DicePool.h"
+#include "DiceRng.h"
+#include <map>
+#include <vector>
+#include <string>
+
+// Table holds the state of exactly one Perudo game. Every broadcast goes
+// to the connections seated at this table only. Binary connections get a
+// Snapshot on join (or Resync) and sequence-numbered deltas afterwards.
+class Table {
+public:
+    using Rules = perudo::StandardRules;
+
+    struct PlayerInfo {
+        Connection* conn = nullptr;
+        std::string name;
+        int diceCount = Rules::dicePerPlayer;
+        bool connected = false;
+        sf::Uint8 id = proto::NoPlayer; // stable per-table id used by the binary protocol
+    };
+
+    enum class Phase { Lobby, Betting, Reveal };
+
+    // Dice come from stream `id` of `diceSeed`, so a table's rolls replay from the seed
+    Table(int id, std::size_t maxPlayers, std::uint64_t diceSeed);
+
+    int getId() const { return id; }
+    std::size_t playerCount() const { return seats.size(); }
+    bool isEmpty() const { return seats.empty(); }
+    bool isOpen() const; // still seating new players (lobby, not started, not full)
+    const std::vector<Connection*>& getSeats() const { return seats; }
+    std::string nameOf(Connection* c) const;
+
+    void join(Connection* c, const std::string& name);
+    void leave(Connection* c);
+    void sendSnapshot(Connection* c); // full state for one binary connection
+
+    // Player commands, already decoded from either wire format
+    void onRoll(Connection* c);
+    void onBet(Connection* c, int count, int face);
+    void onDoubt(Connection* c);
+    void onNext();
+
+private:
+    int id;
+    std::size_t maxPlayers;
+    bool started = false; // set by the first ROLL
+    proto::Seq seq = 0;   // sequence number of the last published delta
+
+    // Game state
+    std::vector<Connection*> seats; // join order
+    std::map<Connection*, PlayerInfo> playersByConn;
+    perudo::DicePool roundDice; // this round's dice, one hand per player id
+    perudo::DiceRng rng;
+    std::vector<Connection*> turnOrder;
+    int turnIndex = 0;
+
+    Phase phase = Phase::Lobby;
+
+    // Current bet
+    std::string currentBetter;
+    int currentBetCount = 0;
+    int currentBetFace = 0; // 1..6
+
+    // Round starters
+    std::string firstRoundStarter;  // who pressed R first
+    std::string lastRoundLoser;     // who lost a die last round (starts next)
+
+    // ---- Internals ----
+    // Binary connections get `msg`, text connections get `text`. An empty
+    // `text` means the text protocol has no such message.
+    template <class Msg> void send(Connection* c, const Msg& msg, const std::string& text);
+    template <class Msg> void broadcast(const Msg& msg, const std::string& text);
+    // Broadcasts a change of shared state, stamped with the next sequence number
+    template <class Msg> void publish(Msg msg, const std::string& text);
+
+    sf::Uint8 idOf(const std::string& name) const;
+    std::string nameById(sf::Uint8 id) const;
+    PlayerInfo* getPlayerByName(const std::string& name);
+    sf::Uint8 freePlayerId() const;
+
+    void setupTurnOrderIfNeeded();
+    void startBettingIfPossible();
+    void advanceTurn();
+
+    void broadcastDiceCount(const PlayerInfo& pi);
+    void broadcastTurn();
+    void broadcastCurrentBet();
+    void broadcastRevealAll();
+
+    void rollAllDice();
+    void sendPrivateDiceToOwners(); // sends "MYDICE ..." to each owner
+
+    // Rules / helpers (the rules themselves live in PerudoRules.h)
+    perudo::RoundState roundState() const;
+    bool isValidRaise(int newCount, int newFace) const;
+    int  countMatching(int betFace) const; // over every die in roundDice
+    bool isPalificoRound() const; // true if the player whose turn it is has exactly 1 die
+
+    void resolveDoubt(Connection* challenger);
+    void beginNextRound();
+};
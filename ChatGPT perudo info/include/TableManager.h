@@ -0,0 +1,40 @@
+#pragma once
+#include "Table.h"
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+// TableManager owns the tables hosted by one server shard and decides
+// which table a connection sits at when it says HELLO. Table ids are
+// allocated as firstId, firstId + idStride, ... so that several managers
+// never hand out the same id.
+class TableManager {
+public:
+    explicit TableManager(std::size_t seatsPerTable = 8, int firstId = 1, int idStride = 1, std::uint64_t diceSeed = 0);
+
+    // Seats the connection at the lowest-numbered open table, creating a
+    // new one when every table is full or already playing.
+    Table& seat(Connection* c, const std::string& name);
+
+    // Removes the connection from its table; empty tables are destroyed.
+    void unseat(Connection* c);
+
+    // Largest table with at most maxPlayers players, or null. Used to pick
+    // a table to hand to another shard.
+    Table* findMovable(std::size_t maxPlayers) const;
+
+    // Transfers ownership of a whole table out of / into this manager.
+    std::unique_ptr<Table> release(int id);
+    void adopt(std::unique_ptr<Table> table);
+
+    std::size_t tableCount() const { return tables.size(); }
+    std::size_t getSeatsPerTable() const { return seatsPerTable; }
+
+private:
+    std::size_t seatsPerTable;
+    int nextTableId;
+    int idStride;
+    std::uint64_t diceSeed; // shared by every table; the table id picks the stream
+    std::unordered_map<int, std::unique_ptr<Table>> tables;
+    std::set<int> openTables; // ids of tables that may still accept players
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Shared ownership of a cached texture. While any handle is alive the
+// texture stays loaded; the cache's own reference does not count.
+using TextureHandle = std::shared_ptr<const sf::Texture>;
+
+// Textures keyed by file name, held within a GPU memory budget.
+//
+// Every get() moves the entry to the front of an LRU list. When the
+// estimated size of all loaded textures exceeds the budget, entries that
+// nobody holds a handle to are released from the back of the list until
+// it fits again. Textures still in use are never evicted, so the budget
+// can be exceeded for as long as they are. Render thread only.
+class TextureCache {
+public:
+    struct Stats {
+        std::size_t hits = 0, misses = 0, evictions = 0, failures = 0;
+        std::size_t bytes = 0;   // estimated GPU memory of loaded textures
+        std::size_t entries = 0;
+    };
+
+    explicit TextureCache(std::size_t budgetBytes = 64u << 20);
+
+    // Empty handle when the file cannot be loaded
+    TextureHandle get(const std::string& filename);
+
+    void setBudget(std::size_t budgetBytes);
+    std::size_t getBudget() const { return budget; }
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Entry {
+        std::shared_ptr<sf::Texture> texture;
+        std::size_t bytes;
+        std::list<std::string>::iterator lru;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru; // front = most recently used
+    std::size_t budget;
+    Stats stats;
+
+    void trim();
+};
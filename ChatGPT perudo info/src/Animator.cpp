@@ -0,0 +1,116 @@
+#include "Animator.h"
+#include <algorithm>
+
+float applyEase(Ease ease, float t) {
+    switch (ease) {
+    case Ease::OutCubic: {
+        float u = 1.f - t;
+        return 1.f - u * u * u;
+    }
+    case Ease::InOutQuad:
+        return t < 0.5f ? 2.f * t * t : 1.f - 2.f * (1.f - t) * (1.f - t);
+    case Ease::OutBack: {
+        const float c = 1.70158f;
+        float u = t - 1.f;
+        return 1.f + (c + 1.f) * u * u * u + c * u * u;
+    }
+    case Ease::Linear:
+    default:
+        return t;
+    }
+}
+
+Animator::Id Animator::add(float initial) {
+    from.push_back(initial);
+    to.push_back(initial);
+    delay.push_back(0.f);
+    duration.push_back(0.f);
+    elapsed.push_back(0.f);
+    ease.push_back(Ease::Linear);
+    previous.push_back(initial);
+    current.push_back(initial);
+    active.push_back(0);
+    return from.size() - 1;
+}
+
+void Animator::tween(Id channel, float start, float end, float seconds, Ease curve, float wait) {
+    if (!active[channel]) ++runningCount;
+    active[channel] = 1;
+    from[channel] = start;
+    to[channel] = end;
+    delay[channel] = wait;
+    duration[channel] = std::max(seconds, step);
+    elapsed[channel] = 0.f;
+    ease[channel] = curve;
+    previous[channel] = current[channel] = start;
+}
+
+void Animator::set(Id channel, float v) {
+    if (active[channel]) --runningCount;
+    active[channel] = 0;
+    from[channel] = to[channel] = v;
+    previous[channel] = current[channel] = v;
+}
+
+bool Animator::update(sf::Time dt) {
+    if (runningCount == 0) {
+        accumulator = 0.f;  // idle time must not turn into a burst of steps later
+        return false;
+    }
+    accumulator = std::min(accumulator + dt.asSeconds(), step * maxStepsPerUpdate);
+    bool moved = false;
+    while (accumulator >= step && runningCount > 0) {
+        moved |= advance();
+        accumulator -= step;
+    }
+    // value() also moves between steps while a tween is past its delay
+    return moved || (runningCount > 0 && untilNextChange() == sf::Time::Zero);
+}
+
+sf::Time Animator::untilNextChange() const {
+    float wait = -1.f;
+    for (std::size_t i = 0; i < active.size(); ++i) {
+        if (!active[i]) continue;
+        float w = std::max(delay[i] - elapsed[i] - accumulator, 0.f);
+        if (wait < 0.f || w < wait) wait = w;
+    }
+    return sf::seconds(std::max(wait, 0.f));
+}
+
+bool Animator::advance() {
+    const std::size_t n = from.size();
+    bool moved = false;
+    for (std::size_t i = 0; i < n; ++i) {
+        previous[i] = current[i];
+        if (!active[i]) continue;
+
+        elapsed[i] += step;
+        float t = (elapsed[i] - delay[i]) / duration[i];
+        if (t <= 0.f) continue;
+        moved = true;
+        if (t >= 1.f) {
+            current[i] = to[i];
+            active[i] = 0;
+            --runningCount;
+            continue;
+        }
+        current[i] = from[i] + (to[i] - from[i]) * applyEase(ease[i], t);
+    }
+    return moved;
+}
+
+float Animator::value(Id channel) const {
+    if (!active[channel]) return current[channel];
+    float alpha = accumulator / step;
+    return previous[channel] + (current[channel] - previous[channel]) * alpha;
+}
+
+Timeline& Timeline::add(float at, Animator::Id channel, float from, float to, float duration, Ease ease) {
+    tracks.push_back({ at, channel, from, to, duration, ease });
+    return *this;
+}
+
+void Timeline::play(Animator& animator) const {
+    for (const Track& t : tracks)
+        animator.tween(t.channel, t.from, t.to, t.duration, t.ease, t.at);
+}
@@ -0,0 +1,87 @@
+#include "AssetLoader.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+AssetLoader::AssetLoader(std::vector<std::pair<std::string, std::string>> atlasFiles, std::string fontFile,
+    std::string packFile)
+    : atlasFiles(std::move(atlasFiles)), fontFile(std::move(fontFile)), packFile(std::move(packFile)) {
+    worker = std::thread(&AssetLoader::load, this);
+}
+
+AssetLoader::~AssetLoader() {
+    if (worker.joinable()) worker.join();
+}
+
+void AssetLoader::load() {
+    // One mapping replaces the individual file opens; without a pack
+    // every asset is read as a loose file.
+    const AssetPack* source = pack.open(packFile) ? &pack : nullptr;
+    if (source) std::cout << "Assets: using " << packFile << std::endl;
+
+    // Font first: it is small and the HUD needs it
+    AssetPack::Blob blob;
+    if (source && source->find(fontFile, blob)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fontBlob = blob;
+    }
+    else {
+        std::ifstream in(fontFile, std::ios::binary);
+        auto bytes = std::make_unique<std::vector<char>>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes->empty()) fontMissing = true;
+        else fontBytes = std::move(bytes);
+    }
+
+    auto sheet = std::make_unique<PackedAtlas>(ResourceManager::packAtlas(atlasFiles, source));
+    std::lock_guard<std::mutex> lock(mutex);
+    packed = std::move(sheet);
+}
+
+void AssetLoader::update(sf::Time budget) {
+    if (!loading()) return;
+    sf::Clock clock;
+
+    bool missing = false;
+    AssetPack::Blob blob;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fontBytes) { fontData = std::move(*fontBytes); fontBytes.reset(); }
+        std::swap(blob, fontBlob);
+        if (packed) uploading = std::move(packed);
+        std::swap(missing, fontMissing);
+    }
+
+    if (!fontLoaded && (blob.data || !fontData.empty())) {
+        fontLoaded = blob.data ? font.loadFromMemory(blob.data, blob.size)
+                               : font.loadFromMemory(fontData.data(), fontData.size());
+        if (!fontLoaded) fontData.clear();
+        missing = !fontLoaded;
+    }
+    if (missing) {
+        std::cerr << "Error: could not load font " << fontFile << std::endl;
+        fontFailed = true;
+    }
+
+    if (!uploading) return;
+    const sf::Image& sheet = uploading->sheet;
+    sf::Vector2u size = sheet.getSize();
+    if (!atlas) {
+        atlas = std::make_unique<sf::Texture>();
+        atlas->create(size.x, size.y);
+    }
+
+    // Upload bands of rows until the frame's budget runs out
+    const unsigned band = 64;
+    while (uploadedRows < size.y && clock.getElapsedTime() < budget) {
+        unsigned rows = std::min(band, size.y - uploadedRows);
+        atlas->update(sheet.getPixelsPtr() + std::size_t(uploadedRows) * size.x * 4, size.x, rows, 0, uploadedRows);
+        uploadedRows += rows;
+    }
+    if (uploadedRows < size.y) return;
+
+    ResourceManager::installAtlas(std::move(atlas), uploading->rects);
+    uploading.reset();
+    atlasInstalled = true;
+}
@@ -0,0 +1,95 @@
+#include "AssetPack.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    HANDLE m = GetFileSizeEx(f, &size) && size.QuadPart > 0
+        ? CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = m ? MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (m) CloseHandle(m);
+        CloseHandle(f);
+        return false;
+    }
+    file = f;
+    mapping = m;
+    base = static_cast<const char*>(view);
+    length = (std::size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        view = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    base = static_cast<const char*>(view);
+    length = (std::size_t)st.st_size;
+#endif
+
+    // Validate the whole index up front so find() can trust it
+    Header header;
+    bool ok = length >= sizeof(header);
+    if (ok) {
+        std::memcpy(&header, base, sizeof(header));
+        ok = std::memcmp(header.magic, "PRDOPACK", 8) == 0 && header.version == Version
+            && header.count <= (length - sizeof(header)) / sizeof(Entry);
+    }
+    for (sf::Uint32 i = 0; ok && i < header.count; ++i) {
+        Entry e;
+        std::memcpy(&e, base + sizeof(header) + i * sizeof(Entry), sizeof(e));
+        e.name[sizeof(e.name) - 1] = '\0';
+        ok = e.offset <= length && e.size <= length - e.offset
+            && (e.kind != Kind::Rgba || sf::Uint64(e.width) * e.height * 4 == e.size);
+        if (ok) index[e.name] = Blob{ e.kind, e.width, e.height, base + e.offset, (std::size_t)e.size };
+    }
+    if (!ok) {
+        std::cerr << "Error: " << path << " is not a valid asset pack" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::close() {
+    index.clear();
+    if (!base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle(mapping);
+    CloseHandle(file);
+    mapping = file = nullptr;
+#else
+    munmap(const_cast<char*>(base), length);
+#endif
+    base = nullptr;
+    length = 0;
+}
+
+bool AssetPack::find(const std::string& name, Blob& out) const {
+    auto it = index.find(name);
+    if (it == index.end()) return false;
+    out = it->second;
+    return true;
+}
@@ -2,102 +2,199 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+
+namespace {
+const char* phaseName(proto::PhaseId phase) {
+    static const char* names[] = { "LOBBY", "BETTING", "REVEAL" };
+    return names[std::min<int>((int)phase, 2)];
+}
+}
+
+Client::~Client() {
+    running = false;
+    wakeNetwork();
+    if (network.joinable()) network.join();
+}
 
 bool Client::connectToServer(const std::string& ip, unsigned short port, const std::string& username) {
-    if (socket.connect(ip, port, sf::milliseconds(3000)) != sf::Socket::Done) {
-        std::cerr << "Client: Failed to connect to " << ip << ":" << port << "\n";
-        connected = false;
-        return false;
-    }
-    socket.setBlocking(false);
-    connected = true;
+    if (network.joinable()) return false; // one connection per Client
     myUsername = username;
+    if (wakeReceiver.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) == sf::Socket::Done) {
+        wakeReceiver.setBlocking(false);
+        wakeSender.setBlocking(false); // a full buffer already means a wake is pending
+        wakePort = wakeReceiver.getLocalPort();
+    }
+    else std::cerr << "Client: no wake socket, commands wait for the next poll\n";
+    running = true;
+    network = std::thread(&Client::networkLoop, this, ip, port, username);
+    return true;
+}
+
+// Retries until connected or the Client is destroyed, doubling the pause
+// between attempts up to five seconds.
+bool Client::connectWithBackoff(const std::string& ip, unsigned short port, const std::string& username) {
+    sf::Time pause = sf::milliseconds(250);
+    while (running) {
+        // A destroyed Client abandons the attempt within one connect slice
+        if (session.connect(ip, port, username, sf::seconds(1), [this] { return running.load(); })) return true;
+        if (!running) break;
+        std::cerr << "Client: retrying in " << pause.asMilliseconds() << " ms\n";
+        for (sf::Clock waited; running && waited.getElapsedTime() < pause;)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        pause = std::min(pause * 2.f, sf::seconds(5));
+    }
+    return false;
+}
+
+// Network thread: connects, then sends queued commands, decodes everything
+// readable and sleeps in the selector otherwise. Queuing a command wakes
+// the selector through the loopback wake socket; each pass also retries
+// output the server socket refused, polling only while some is left.
+void Client::networkLoop(std::string ip, unsigned short port, std::string username) {
+    if (!connectWithBackoff(ip, port, username)) return;
+    while (running && !events.push(Connected{}))
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    notifyEvents();
+
+    sf::SocketSelector selector;
+    selector.add(session.getSocket());
+    if (wakePort) selector.add(wakeReceiver);
+    ServerEvent event;
+    bool pending = false; // decoded, but the render thread's queue was full
+
+    while (running) {
+        ClientCommand cmd;
+        while (commands.pop(cmd)) session.send(cmd);
+
+        if (pending) {
+            if (!events.push(std::move(event))) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            pending = false;
+        }
+        bool received = false;
+        while (session.receive(event)) {
+            if (!events.push(std::move(event))) { pending = true; break; }
+            received = true;
+        }
+        if (received) notifyEvents();
+        if (!session.isConnected()) {
+            if (!pending) break;
+            continue;
+        }
+        if (pending) continue;
+
+        // Idle, this blocks until the server or the render thread has
+        // something; the destructor wakes it too
+        sf::Time timeout = sf::Time::Zero; // no timeout
+        if (session.hasPendingOutput() || !wakePort) timeout = sf::milliseconds(2);
+        if (selector.wait(timeout) && wakePort && selector.isReady(wakeReceiver)) {
+            char drain[64];
+            std::size_t got;
+            sf::IpAddress from;
+            unsigned short fromPort;
+            while (wakeReceiver.receive(drain, sizeof drain, got, from, fromPort) == sf::Socket::Done) {}
+        }
+    }
+    session.disconnect();
+}
+
+void Client::wakeNetwork() {
+    if (!wakePort) return;
+    char b = 0;
+    wakeSender.send(&b, 1, sf::IpAddress::LocalHost, wakePort);
+}
+
+void Client::notifyEvents() {
+    // Taking the lock orders the push before a waiter's empty() check
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wake.notify_one();
+}
 
-    sf::Packet p; p << std::string("HELLO ") + username;
-    socket.send(p);
-    std::cout << "Client: connected, sent HELLO " << username << "\n";
+void Client::waitForEvents(sf::Time timeout) {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wake.wait_for(lock, std::chrono::microseconds(timeout.asMicroseconds()), [this] { return !events.empty(); });
+}
+
+bool Client::sendCommand(ClientCommand cmd) {
+    if (!commands.push(std::move(cmd))) return false;
+    wakeNetwork();
     return true;
 }
 
 bool Client::requestRoll() {
     if (!connected || gameStarted) return false; // allow only once
-    sf::Packet p; p << std::string("ROLL");
-    bool ok = (socket.send(p) == sf::Socket::Done);
+    bool ok = sendCommand(proto::Roll{});
     if (ok) gameStarted = true;
     return ok;
 }
 
 bool Client::sendBet(int count, int face) {
     if (!connected) return false;
-    std::ostringstream oss; oss << "BET " << count << ' ' << face;
-    sf::Packet p; p << oss.str();
-    return socket.send(p) == sf::Socket::Done;
+    // Same bounds as the server. Each field is one byte on the wire, so a
+    // larger count would wrap into a different, legal-looking bid.
+    if (count < 1 || count > 255 || face < 1 || face > 6) {
+        std::cerr << "Client: bet " << count << " x " << face << " is out of range, not sent\n";
+        return false;
+    }
+    return sendCommand(proto::Bet{ (sf::Uint8)count, (sf::Uint8)face });
 }
 
 bool Client::sendDoubt() {
     if (!connected) return false;
-    sf::Packet p; p << std::string("DOUBT");
-    return socket.send(p) == sf::Socket::Done;
+    return sendCommand(proto::Doubt{});
 }
 
 bool Client::sendNextRound() {
     if (!connected) return false;
-    sf::Packet p; p << std::string("NEXT");
-    return socket.send(p) == sf::Socket::Done;
+    return sendCommand(proto::Next{});
 }
 
-bool Client::poll() {
-    if (!connected) return false;
-
-    sf::Packet p;
-    auto s = socket.receive(p);
-    if (s == sf::Socket::NotReady) return false;
-    if (s == sf::Socket::Disconnected) {
-        std::cerr << "Client: disconnected\n";
-        connected = false;
-        return false;
-    }
-    if (s != sf::Socket::Done) return false;
-
-    std::string line;
-    if (!(p >> line)) return false;
+int Client::poll(sf::Time budget) {
+    sf::Clock clock;
+    int handled = 0;
+    ServerEvent event;
+    do {
+        if (!events.pop(event)) break;
+        std::visit([this](const auto& e) { apply(e); }, event);
+        ++handled;
+    } while (clock.getElapsedTime() < budget);
+    return handled;
+}
 
+// ---- Text protocol ----
+void Client::apply(const TextLine& e) {
+    const std::string& line = e.line;
     lastMessage = line;
 
     if (line.rfind("WELCOME ", 0) == 0) {
-        return true;
+        return;
     }
 
     if (line.rfind("PHASE ", 0) == 0) {
-        phase = line.substr(6);
-        if (phase == "BETTING") {
-            // clear previous reveal
-            for (auto& kv : players) kv.second.revealedDice.clear();
-        }
-        return true;
+        applyPhase(line.substr(6));
+        return;
     }
 
     if (line.rfind("TURN ", 0) == 0) {
         currentTurn = line.substr(5);
-        return true;
+        return;
     }
 
     if (line.rfind("CURRENTBET ", 0) == 0) {
         std::istringstream iss(line.substr(11));
         std::string who; int count, face;
         if (iss >> who >> count >> face) {
-            if (who == "None") {
-                currentBetter.clear();
-                currentBetCount = 0;
-                currentBetFace = 0;
-            }
-            else {
-                currentBetter = who;
-                currentBetCount = count;
-                currentBetFace = face;
-            }
+            applyCurrentBet(who == "None" ? std::string() : who, count, face);
         }
-        return true;
+        return;
+    }
+
+    if (line.rfind("LEFT ", 0) == 0) {
+        players.erase(line.substr(5));
+        return;
     }
 
     if (line.rfind("DICECOUNT ", 0) == 0) {
@@ -106,7 +203,7 @@ bool Client::poll() {
         if (iss >> name >> n) {
             players[name].diceCount = n;
         }
-        return true;
+        return;
     }
 
     if (line.rfind("REVEAL ", 0) == 0) {
@@ -117,25 +214,160 @@ bool Client::poll() {
             int v;
             while (iss >> v) players[name].revealedDice.push_back(v);
         }
-        return true;
+        return;
     }
 
     if (line.rfind("MYDICE", 0) == 0) {
         std::istringstream iss(line.substr(6));
-        players[myUsername].revealedDice.clear();
+        std::vector<int> dice;
         int v;
-        while (iss >> v) players[myUsername].revealedDice.push_back(v);
-        std::cout << "Client: MYDICE -> ";
-        for (int d : players[myUsername].revealedDice) std::cout << d << " ";
-        std::cout << "\n";
-        return true;
+        while (iss >> v) dice.push_back(v);
+        applyMyDice(dice);
+        return;
     }
 
     if (line.rfind("INFO ", 0) == 0) {
         std::cout << "Server info: " << line.substr(5) << "\n";
-        return true;
+        return;
     }
 
     std::cout << "Client: unknown line: " << line << "\n";
-    return true;
+}
+
+void Client::apply(const Connected&) {
+    connected = true;
+    lastMessage = "CONNECTED";
+}
+
+void Client::apply(const Disconnected&) {
+    connected = false;
+    lastMessage = "DISCONNECTED";
+}
+
+// ---- Binary protocol ----
+void Client::apply(const proto::Snapshot& m) {
+    namesById.clear();
+    players.clear();
+    for (auto& seat : m.seats) {
+        if (namesById.size() <= seat.player) namesById.resize(seat.player + 1);
+        namesById[seat.player] = seat.name;
+        auto& ps = players[seat.name];
+        ps.diceCount = seat.diceCount;
+        ps.revealedDice.assign(seat.revealed.begin(), seat.revealed.end());
+    }
+    phase = phaseName(m.phase);
+    currentTurn = m.turn == proto::NoPlayer ? std::string() : nameOf(m.turn);
+    applyCurrentBet(m.better == proto::NoPlayer ? std::string() : nameOf(m.better), m.count, m.face);
+    if (!m.myDice.empty()) players[myUsername].revealedDice.assign(m.myDice.begin(), m.myDice.end());
+
+    lastSeq = m.seq;
+    synced = true;
+    lastMessage = "SNAPSHOT";
+}
+
+void Client::apply(const proto::Player& m) {
+    if (!inSequence(m.seq)) return;
+    if (namesById.size() <= m.player) namesById.resize(m.player + 1);
+    if (m.name.empty()) players.erase(namesById[m.player]); // left the table
+    namesById[m.player] = m.name;
+    lastMessage = "PLAYER";
+}
+
+void Client::apply(const proto::DiceCount& m) {
+    if (!inSequence(m.seq)) return;
+    players[nameOf(m.player)].diceCount = m.count;
+    lastMessage = "DICECOUNT";
+}
+
+void Client::apply(const proto::Phase& m) {
+    if (!inSequence(m.seq)) return;
+    applyPhase(phaseName(m.phase));
+    lastMessage = "PHASE";
+}
+
+void Client::apply(const proto::Turn& m) {
+    if (!inSequence(m.seq)) return;
+    currentTurn = nameOf(m.player);
+    lastMessage = "TURN";
+}
+
+void Client::apply(const proto::CurrentBet& m) {
+    if (!inSequence(m.seq)) return;
+    applyCurrentBet(m.player == proto::NoPlayer ? std::string() : nameOf(m.player), m.count, m.face);
+    lastMessage = "CURRENTBET";
+}
+
+void Client::apply(const proto::Reveal& m) {
+    if (!inSequence(m.seq)) return;
+    players[nameOf(m.player)].revealedDice.assign(m.dice.begin(), m.dice.end());
+    lastMessage = "REVEAL";
+}
+
+void Client::apply(const proto::MyDice& m) {
+    applyMyDice(std::vector<int>(m.dice.begin(), m.dice.end()));
+    lastMessage = "MYDICE";
+}
+
+void Client::apply(const proto::Info& m) {
+    if (!inSequence(m.seq)) return;
+    static const char* names[] = { "LostDie", "Eliminated", "Winner" };
+    std::cout << "Server info: " << names[std::min<int>((int)m.info, 2)];
+    if (m.player != proto::NoPlayer) std::cout << ' ' << nameOf(m.player);
+    if (m.info == proto::InfoId::LostDie) std::cout << ' ' << (int)m.value;
+    std::cout << "\n";
+    lastMessage = "INFO";
+}
+
+void Client::apply(const proto::Reject& m) {
+    std::cout << "Server info: " << (m.reason == proto::RejectId::NotYourTurn ? "NotYourTurn" : "InvalidBet") << "\n";
+    lastMessage = "INFO";
+}
+
+// Deltas must arrive in order. After a gap nothing is applied until the
+// Snapshot requested here has replaced the whole state.
+bool Client::inSequence(proto::Seq seq) {
+    if (!synced) return false;
+    if (seq == (proto::Seq)(lastSeq + 1)) {
+        lastSeq = seq;
+        return true;
+    }
+    std::cerr << "Client: missed update " << (lastSeq + 1) << " (got " << seq << "), resyncing\n";
+    synced = false;
+    sendCommand(proto::Resync{});
+    return false;
+}
+
+std::string Client::nameOf(sf::Uint8 id) const {
+    if (id < namesById.size() && !namesById[id].empty()) return namesById[id];
+    return "Unknown";
+}
+
+// ---- Shared state updates ----
+void Client::applyPhase(const std::string& newPhase) {
+    phase = newPhase;
+    if (phase == "BETTING") {
+        // clear previous reveal
+        for (auto& kv : players) kv.second.revealedDice.clear();
+    }
+}
+
+void Client::applyCurrentBet(const std::string& who, int count, int face) {
+    if (who.empty()) {
+        currentBetter.clear();
+        currentBetCount = 0;
+        currentBetFace = 0;
+    }
+    else {
+        currentBetter = who;
+        currentBetCount = count;
+        currentBetFace = face;
+    }
+}
+
+void Client::applyMyDice(const std::vector<int>& dice) {
+    players[myUsername].revealedDice = dice;
+    ++myDiceSerial;
+    std::cout << "Client: MYDICE -> ";
+    for (int d : players[myUsername].revealedDice) std::cout << d << " ";
+    std::cout << "\n";
 }
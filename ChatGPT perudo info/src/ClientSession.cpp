@@ -0,0 +1,175 @@
+#include "ClientSession.h"
+#include "SocketHandle.h"
+#include <iostream>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#include <sys/socket.h>
+#endif
+
+namespace {
+// How long one wait on a connect in flight lasts before the caller is
+// asked whether to keep waiting
+constexpr int connectSliceMs = 10;
+
+// 1 once the handshake finished, 0 while it is still going, -1 if it failed
+int waitConnected(sf::SocketHandle handle, int ms) {
+    fd_set writable, failed;
+    FD_ZERO(&writable); FD_SET(handle, &writable);
+    FD_ZERO(&failed); FD_SET(handle, &failed); // Windows reports refusals here
+    timeval tv{ 0, ms * 1000 };
+    int n = select((int)handle + 1, nullptr, &writable, &failed, &tv);
+    if (n == 0) return 0;
+    if (n < 0) return -1;
+    int error = 0;
+#ifdef _WIN32
+    int len = sizeof(error);
+#else
+    socklen_t len = sizeof(error);
+#endif
+    if (getsockopt(handle, SOL_SOCKET, SO_ERROR, (char*)&error, &len) != 0 || error != 0) return -1;
+    return 1;
+}
+
+// Text form of each command; Resync has none (text clients never gap)
+struct TextOf {
+    std::string operator()(const proto::Roll&) const { return "ROLL"; }
+    std::string operator()(const proto::Bet& b) const {
+        return "BET " + std::to_string(b.count) + ' ' + std::to_string(b.face);
+    }
+    std::string operator()(const proto::Doubt&) const { return "DOUBT"; }
+    std::string operator()(const proto::Next&) const { return "NEXT"; }
+    std::string operator()(const proto::Resync&) const { return ""; }
+};
+
+template <class Msg>
+bool decodeAs(const sf::Packet& p, ServerEvent& out) {
+    Msg msg;
+    if (!proto::decode(p, msg)) return false;
+    out = std::move(msg);
+    return true;
+}
+}
+
+bool ClientSession::connect(const std::string& ip, unsigned short port, const std::string& username, sf::Time timeout,
+                            const std::function<bool()>& keepWaiting) {
+    // Non-blocking, so the handshake is waited on here in short slices
+    // rather than inside SFML where it could not be abandoned
+    socket.setBlocking(false);
+    sf::Socket::Status status = socket.connect(ip, port);
+    if (status == sf::Socket::NotReady) {
+        int state = 0;
+        for (sf::Clock clock; state == 0 && clock.getElapsedTime() < timeout;) {
+            if (keepWaiting && !keepWaiting()) break;
+            state = waitConnected(SocketHandleAccess::of(socket), connectSliceMs);
+        }
+        status = state > 0 ? sf::Socket::Done : sf::Socket::Error;
+    }
+    if (status != sf::Socket::Done) {
+        socket.disconnect();
+        if (logging) std::cerr << "Client: Failed to connect to " << ip << ":" << port << "\n";
+        connected = false;
+        return false;
+    }
+    connected = true;
+    protocol = 0;
+    outbox.clear();
+
+    // Offer the binary protocol first; old servers simply ignore the line.
+    sf::Packet offer; offer << "PROTO " + std::to_string(proto::Version);
+    sendPacket(offer);
+
+    sf::Packet p; p << std::string("HELLO ") + username;
+    sendPacket(p);
+    if (logging) std::cout << "Client: connected, sent HELLO " << username << "\n";
+    return true;
+}
+
+void ClientSession::disconnect() {
+    socket.disconnect();
+    connected = false;
+    outbox.clear();
+}
+
+bool ClientSession::send(const ClientCommand& cmd) {
+    if (!connected) return false;
+    sf::Packet p;
+    if (protocol) std::visit([&](const auto& msg) { proto::encode(msg, p); }, cmd);
+    else {
+        std::string text = std::visit(TextOf{}, cmd);
+        if (text.empty()) return true;
+        p << text;
+    }
+    return sendPacket(p);
+}
+
+bool ClientSession::sendPacket(sf::Packet& p) {
+    outbox.push_back(std::move(p));
+    return flush();
+}
+
+// A non-blocking socket may take a packet in several pieces, or none of it
+// while its buffer is full. SFML remembers how much of a packet went out,
+// so the same packet object is offered again until it is Done.
+bool ClientSession::flush() {
+    while (!outbox.empty()) {
+        auto s = socket.send(outbox.front());
+        if (s == sf::Socket::Done) {
+            outbox.pop_front();
+            continue;
+        }
+        return s == sf::Socket::Partial || s == sf::Socket::NotReady; // else Disconnected / Error
+    }
+    return true;
+}
+
+bool ClientSession::receive(ServerEvent& out) {
+    if (connected && !outbox.empty()) flush(); // a failure surfaces below
+    while (connected) {
+        sf::Packet p;
+        auto s = socket.receive(p);
+        if (s == sf::Socket::NotReady) return false;
+        if (s != sf::Socket::Done) {
+            if (logging) std::cerr << "Client: disconnected\n";
+            connected = false;
+            out = Disconnected{};
+            return true;
+        }
+
+        if (proto::isBinary(p)) {
+            if (decodeBinary(p, out)) return true;
+            continue;
+        }
+
+        std::string line;
+        if (!(p >> line)) continue;
+        if (line.rfind("PROTO ", 0) == 0) {
+            protocol = (sf::Uint8)std::atoi(line.c_str() + 6);
+            continue;
+        }
+        out = TextLine{ std::move(line) };
+        return true;
+    }
+    return false;
+}
+
+bool ClientSession::decodeBinary(const sf::Packet& p, ServerEvent& out) {
+    switch (proto::opcode(p)) {
+    case proto::Op::Snapshot:   return decodeAs<proto::Snapshot>(p, out);
+    case proto::Op::Player:     return decodeAs<proto::Player>(p, out);
+    case proto::Op::DiceCount:  return decodeAs<proto::DiceCount>(p, out);
+    case proto::Op::Phase:      return decodeAs<proto::Phase>(p, out);
+    case proto::Op::Turn:       return decodeAs<proto::Turn>(p, out);
+    case proto::Op::CurrentBet: return decodeAs<proto::CurrentBet>(p, out);
+    case proto::Op::Reveal:     return decodeAs<proto::Reveal>(p, out);
+    case proto::Op::MyDice:     return decodeAs<proto::MyDice>(p, out);
+    case proto::Op::Info:       return decodeAs<proto::Info>(p, out);
+    case proto::Op::Reject:     return decodeAs<proto::Reject>(p, out);
+    default:
+        if (logging) std::cerr << "Client: unknown opcode " << (int)proto::opcode(p) << "\n";
+        return false;
+    }
+}
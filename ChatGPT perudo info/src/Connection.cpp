@@ -0,0 +1,77 @@
+#include "Connection.h"
+#include "SocketHandle.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <cerrno>
+#endif
+
+namespace {
+constexpr int maxSpans = 64; // frames gathered into one write
+}
+
+void Connection::send(Frame frame) {
+    if (overflowed || outbox.size() + frame->size() > hardQueueLimit) {
+        overflowed = true; // the peer is missing state now; only eviction is left
+        return;
+    }
+    if (outbox.empty()) lastProgress.restart();
+    outbox.push(std::move(frame));
+    peakQueued = std::max(peakQueued, outbox.size());
+}
+
+void Connection::sendLine(const std::string& line) {
+    sf::Packet out; out << line;
+    send(out);
+}
+
+bool Connection::flush() {
+    while (!outbox.empty()) {
+        const char* ptr[maxSpans]; std::size_t len[maxSpans];
+        int spans = outbox.spans(ptr, len, maxSpans);
+        std::size_t wanted = 0, sent = 0;
+
+#ifdef __linux__
+        // Many queued frames in one call, without SIGPIPE on a dead peer
+        iovec iov[maxSpans];
+        for (int i = 0; i < spans; ++i) {
+            iov[i].iov_base = const_cast<char*>(ptr[i]);
+            iov[i].iov_len = len[i];
+            wanted += len[i];
+        }
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = spans;
+        ssize_t n = sendmsg(SocketHandleAccess::of(*socket), &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        sent = (std::size_t)n;
+#else
+        (void)spans;
+        wanted = len[0];
+        auto s = socket->send(ptr[0], len[0], sent);
+        if (s == sf::Socket::Disconnected || s == sf::Socket::Error) return false;
+#endif
+
+        if (sent > 0) {
+            outbox.consume(sent);
+            lastProgress.restart();
+        }
+        if (sent < wanted) return true; // kernel buffer full; wait until writable
+    }
+    return true;
+}
+
+bool Connection::isSlowConsumer() const {
+    if (overflowed) return true;
+    return outbox.size() > softQueueLimit && lastProgress.getElapsedTime().asMilliseconds() >= stallTimeoutMs;
+}
+
+sf::Int32 Connection::msUntilStalled() const {
+    if (outbox.size() <= softQueueLimit) return -1;
+    return std::max(0, stallTimeoutMs - lastProgress.getElapsedTime().asMilliseconds());
+}
@@ -0,0 +1,69 @@
+#include "DiceBatch.h"
+
+DiceBatch::DiceBatch(std::size_t seats)
+    : slots(seats * slotsPerSeat) {
+}
+
+int DiceBatch::addImage(const sf::Texture& texture, const sf::IntRect& rect) {
+    std::size_t layer = 0;
+    while (layer < layers.size() && layers[layer].texture != &texture) ++layer;
+    if (layer == layers.size()) {
+        layers.push_back({ &texture, sf::VertexArray(sf::Quads, slots.size() * 4) });
+    }
+    images.push_back({ layer, sf::FloatRect((float)rect.left, (float)rect.top, (float)rect.width, (float)rect.height) });
+    return (int)images.size() - 1;
+}
+
+void DiceBatch::place(std::size_t slot, int image, sf::Vector2f center, sf::Vector2f size) {
+    Slot& s = slots[slot];
+    if (s.image == image && s.center == center && s.size == size) return;
+
+    std::size_t layer = images[image].layer;
+    if (s.image < 0) layers[layer].shown++;
+    else if (images[s.image].layer != layer) {
+        collapseQuad(images[s.image].layer, slot);
+        layers[images[s.image].layer].shown--;
+        layers[layer].shown++;
+    }
+    s.image = image;
+    s.center = center;
+    s.size = size;
+    writeQuad(slot);
+}
+
+void DiceBatch::hide(std::size_t slot) {
+    Slot& s = slots[slot];
+    if (s.image < 0) return;
+    std::size_t layer = images[s.image].layer;
+    collapseQuad(layer, slot);
+    layers[layer].shown--;
+    s.image = -1;
+}
+
+void DiceBatch::writeQuad(std::size_t slot) {
+    const Slot& s = slots[slot];
+    const Image& img = images[s.image];
+    sf::Vertex* q = &layers[img.layer].quads[slot * 4];
+
+    float l = s.center.x - s.size.x / 2.f, r = l + s.size.x;
+    float t = s.center.y - s.size.y / 2.f, b = t + s.size.y;
+    float u0 = img.uv.left, u1 = u0 + img.uv.width;
+    float v0 = img.uv.top, v1 = v0 + img.uv.height;
+
+    q[0].position = { l, t }; q[0].texCoords = { u0, v0 };
+    q[1].position = { r, t }; q[1].texCoords = { u1, v0 };
+    q[2].position = { r, b }; q[2].texCoords = { u1, v1 };
+    q[3].position = { l, b }; q[3].texCoords = { u0, v1 };
+}
+
+void DiceBatch::collapseQuad(std::size_t layer, std::size_t slot) {
+    sf::Vertex* q = &layers[layer].quads[slot * 4];
+    for (int i = 0; i < 4; ++i) q[i].position = { 0.f, 0.f };
+}
+
+void DiceBatch::draw(sf::RenderTarget& target) const {
+    for (auto& layer : layers) {
+        if (layer.shown == 0) continue;
+        target.draw(layer.quads, sf::RenderStates(layer.texture));
+    }
+}
@@ -0,0 +1,102 @@
+#include "Hud.h"
+
+Hud::Hud(std::size_t seatCount)
+    : seats(seatCount) {
+    style(statusText, titleSize, 14, 10);
+    style(betText, titleSize, 14, 36);
+    style(selectionText, labelSize, 14, 62);
+    for (auto& seat : seats) style(seat.text, labelSize, 0, 0);
+}
+
+void Hud::style(sf::Text& text, unsigned size, float x, float y) {
+    text.setCharacterSize(size);
+    text.setFillColor(sf::Color::White);
+    text.setPosition(x, y);
+}
+
+void Hud::setFont(const sf::Font& f) {
+    font = &f;
+    statusText.setFont(f);
+    betText.setFont(f);
+    selectionText.setFont(f);
+    for (auto& seat : seats) seat.text.setFont(f);
+    for (auto& label : buttonLabels) label.setFont(f);
+
+    // Rasterize printable ASCII at both sizes now, so the first frame
+    // that shows a new name or number does not stall on glyph uploads.
+    for (unsigned size : { labelSize, titleSize }) {
+        for (sf::Uint32 c = 32; c < 127; ++c) f.getGlyph(c, size, false);
+    }
+}
+
+void Hud::addButton(const sf::FloatRect& rect, const std::string& label) {
+    sf::RectangleShape shape;
+    shape.setPosition(rect.left, rect.top);
+    shape.setSize({ rect.width, rect.height });
+    shape.setFillColor(sf::Color(20, 20, 20, 180));
+    shape.setOutlineColor(sf::Color::White);
+    shape.setOutlineThickness(1.f);
+    buttonRects.push_back(shape);
+
+    sf::Text text;
+    style(text, labelSize, rect.left + 10, rect.top + 5);
+    text.setString(label);
+    if (font) text.setFont(*font);
+    buttonLabels.push_back(text);
+}
+
+void Hud::setStatus(bool connected, const std::string& phase, const std::string& turn) {
+    if (connected == status.connected && phase == status.phase && turn == status.turn) return;
+    status = { connected, phase, turn };
+    std::string head = connected ? "Phase: " + phase : std::string("Connecting...");
+    statusText.setString(head + "    Turn: " + turn);
+}
+
+void Hud::setBet(const std::string& better, int count, int face) {
+    if (better == bet.better && count == bet.count && face == bet.face) return;
+    bet = { better, count, face };
+    std::string betStr = count > 0
+        ? (better + ": " + std::to_string(count) + " x " + std::to_string(face) + "s")
+        : "No bet yet";
+    betText.setString("Current Bet: " + betStr);
+}
+
+void Hud::setSelection(int count, int face, bool valid) {
+    if (count == selCount && face == selFace && valid == selValid) return;
+    selCount = count;
+    selFace = face;
+    selValid = valid;
+    selectionText.setString("Select -> Count: " + std::to_string(count) + "  Face: " + std::to_string(face) +
+                            (valid ? "" : "  (not a valid raise)"));
+}
+
+void Hud::setSeat(std::size_t index, const std::string& name, int diceCount, sf::Vector2f position) {
+    Seat& seat = seats[index];
+    seat.visible = true;
+    if (position != seat.position) {
+        seat.position = position;
+        seat.text.setPosition(position.x - 60, position.y + 70);
+    }
+    if (name == seat.name && diceCount == seat.diceCount) return;
+    seat.name = name;
+    seat.diceCount = diceCount;
+    seat.text.setString(name + " (" + std::to_string(diceCount) + ")");
+}
+
+void Hud::hideSeat(std::size_t index) {
+    seats[index].visible = false;
+}
+
+void Hud::draw(sf::RenderTarget& target) const {
+    if (!font) return;
+    for (auto& seat : seats) {
+        if (seat.visible) target.draw(seat.text);
+    }
+    target.draw(statusText);
+    target.draw(betText);
+    target.draw(selectionText);
+    for (std::size_t i = 0; i < buttonRects.size(); ++i) {
+        target.draw(buttonRects[i]);
+        target.draw(buttonLabels[i]);
+    }
+}
@@ -0,0 +1,203 @@
+#include "LoadBot.h"
+#include <algorithm>
+#include <type_traits>
+
+const char* commandName(Command c) {
+    switch (c) {
+    case Command::Roll:  return "ROLL";
+    case Command::Bet:   return "BET";
+    case Command::Doubt: return "DOUBT";
+    case Command::Next:  return "NEXT";
+    default:             return "-";
+    }
+}
+
+LoadBot::LoadBot(std::string name, const LoadConfig& config, LoadStats& stats)
+    : name(std::move(name)), config(config), stats(stats) {
+    session.setLogging(false);
+}
+
+bool LoadBot::connect() {
+    reset();
+    if (!session.connect(config.host, config.port, name, sf::seconds(2))) return false;
+    stats.connects.fetch_add(1, std::memory_order_relaxed);
+    joinedAt = lastHeard = Clock::now();
+    return true;
+}
+
+void LoadBot::disconnect() {
+    session.disconnect();
+}
+
+void LoadBot::reset() {
+    you = proto::NoPlayer;
+    phase = proto::PhaseId::Lobby;
+    started = myTurn = gameOver = false;
+    diceOf.fill(0);
+    players.clear();
+    bet = proto::CurrentBet{};
+    myDice.clear();
+    myFaces.fill(0);
+    pending = Command::None;
+}
+
+bool LoadBot::service(Clock::time_point now) {
+    ServerEvent e;
+    while (session.receive(e)) {
+        if (std::holds_alternative<Disconnected>(e)) return false;
+        stats.messages.fetch_add(1, std::memory_order_relaxed);
+        lastHeard = now;
+        apply(e);
+    }
+    if (gameOver) {
+        session.disconnect();
+        return false;
+    }
+    if (now - lastHeard > config.stallTimeout) {
+        stats.stalls.fetch_add(1, std::memory_order_relaxed);
+        session.disconnect();
+        return false;
+    }
+    act(now);
+    return true;
+}
+
+void LoadBot::apply(const ServerEvent& e) {
+    std::visit([&](const auto& m) {
+        using T = std::decay_t<decltype(m)>;
+        if constexpr (std::is_same_v<T, proto::Snapshot>) {
+            you = m.you;
+            phase = m.phase;
+            started = m.phase != proto::PhaseId::Lobby;
+            myTurn = m.turn == you;
+            bet = proto::CurrentBet{ m.seq, m.better, m.count, m.face };
+            players.clear();
+            for (const auto& s : m.seats) {
+                players.push_back(s.player);
+                diceOf[s.player] = s.diceCount;
+            }
+            myDice = m.myDice;
+            myFaces = perudo::tallyFaces(myDice.begin(), myDice.end());
+        }
+        else if constexpr (std::is_same_v<T, proto::Player>) {
+            auto seen = std::find(players.begin(), players.end(), m.player);
+            if (m.name.empty()) { // left the table
+                if (seen != players.end()) players.erase(seen);
+                diceOf[m.player] = 0;
+            }
+            else if (seen == players.end()) players.push_back(m.player);
+        }
+        else if constexpr (std::is_same_v<T, proto::DiceCount>) {
+            diceOf[m.player] = m.count;
+        }
+        else if constexpr (std::is_same_v<T, proto::Phase>) {
+            phase = m.phase;
+            if (phase == proto::PhaseId::Betting) {
+                started = true;
+                bet = proto::CurrentBet{}; // the server clears it for every round
+                if (pending == Command::Roll || pending == Command::Next) answered(pending);
+            }
+            if (phase == proto::PhaseId::Reveal && pending == Command::Doubt) answered(pending);
+        }
+        else if constexpr (std::is_same_v<T, proto::Turn>) {
+            myTurn = m.player == you;
+        }
+        else if constexpr (std::is_same_v<T, proto::CurrentBet>) {
+            if (pending == Command::Bet && m.player == you && m.count == bet.count && m.face == bet.face)
+                answered(pending);
+            bet = m;
+        }
+        else if constexpr (std::is_same_v<T, proto::MyDice>) {
+            myDice = m.dice;
+            myFaces = perudo::tallyFaces(myDice.begin(), myDice.end());
+        }
+        else if constexpr (std::is_same_v<T, proto::Info>) {
+            if (m.info == proto::InfoId::Winner) {
+                if (m.player == you) stats.games.fetch_add(1, std::memory_order_relaxed);
+                gameOver = true;
+            }
+            // The loser opens the next round; once the game is over the
+            // server ignores it.
+            else if (m.info == proto::InfoId::LostDie && m.player == you) {
+                sendCommand(proto::Next{}, Command::Next);
+            }
+        }
+        else if constexpr (std::is_same_v<T, proto::Reject>) {
+            stats.rejects.fetch_add(1, std::memory_order_relaxed);
+            pending = Command::None;
+            // An invalid raise is answered with a doubt instead
+            if (m.reason == proto::RejectId::InvalidBet && bet.count > 0)
+                sendCommand(proto::Doubt{}, Command::Doubt);
+        }
+    }, e);
+}
+
+void LoadBot::answered(Command c) {
+    // Timed per message, not per service() pass: a reply can arrive within the pass that sent the command
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sentAt).count();
+    stats.latencyUs[(std::size_t)c].push_back((std::uint32_t)std::min<long long>(us, UINT32_MAX));
+    pending = Command::None;
+}
+
+void LoadBot::sendCommand(const ClientCommand& cmd, Command kind) {
+    sentAt = Clock::now();
+    if (!session.send(cmd)) return;
+    stats.commands.fetch_add(1, std::memory_order_relaxed);
+    pending = kind;
+}
+
+void LoadBot::act(Clock::time_point now) {
+    if (pending != Command::None || you == proto::NoPlayer) return;
+
+    if (!started) {
+        // The lowest id rolls once the table is full; anyone may after a
+        // while, in case that player left.
+        bool leader = std::all_of(players.begin(), players.end(), [&](sf::Uint8 p) { return p >= you; });
+        auto waited = now - joinedAt;
+        bool enough = players.size() >= config.tableSize ||
+            (players.size() >= 2 && waited > (leader ? config.lobbyWait : 2 * config.lobbyWait));
+        if (enough && (leader || waited > 2 * config.lobbyWait)) sendCommand(proto::Roll{}, Command::Roll);
+        return;
+    }
+
+    if (!myTurn || phase != proto::PhaseId::Betting || myDice.empty()) return;
+
+    if (bet.count == 0) {
+        // Open on the face we hold most of, never on ones
+        int best = 2;
+        for (int f = 3; f <= 6; ++f)
+            if (expected(f) > expected(best)) best = f;
+        int count = std::max(1, (int)expected(best));
+        bet.count = (sf::Uint8)count; bet.face = (sf::Uint8)best;
+        sendCommand(proto::Bet{ bet.count, bet.face }, Command::Bet);
+        return;
+    }
+
+    // Doubt a bid comfortably above what the table is likely to hold, or
+    // one that cannot be raised on the same face; otherwise raise by one.
+    perudo::Bid raise{ (sf::Uint8)(bet.count + 1), bet.face };
+    if (bet.count > expected(bet.face) + 1.0 || bet.count >= 255 || !perudo::isValidRaise<Rules>(round(), raise)) {
+        sendCommand(proto::Doubt{}, Command::Doubt);
+        return;
+    }
+    bet.count = raise.count;
+    sendCommand(proto::Bet{ bet.count, bet.face }, Command::Bet);
+}
+
+perudo::RoundState LoadBot::round() const {
+    perudo::RoundState r;
+    r.bid = { bet.count, bet.face };
+    r.turnDice = you != proto::NoPlayer ? diceOf[you] : 0; // bots only think on their own turn
+    return r;
+}
+
+double LoadBot::expected(int face) const {
+    bool palifico = perudo::isPalifico<Rules>(round());
+    int mine = perudo::countMatching<Rules>(myFaces, (sf::Uint8)face, palifico);
+    int others = 0;
+    for (sf::Uint8 p : players)
+        if (p != you) others += diceOf[p];
+    // Chance that an unseen die counts: its own face, plus ones when they are wild
+    double chance = perudo::matches<Rules>(1, (sf::Uint8)face, palifico) ? 2.0 / 6.0 : 1.0 / 6.0;
+    return mine + others * chance;
+}
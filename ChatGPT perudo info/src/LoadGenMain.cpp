@@ -0,0 +1,160 @@
+#include "LoadBot.h"
+#include "Reactor.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless load generator: PerudoLoadGen [bots] [seconds] [host] [port] [tableSize]
+//
+// Runs the bots on a few worker threads, each waiting on its own bots'
+// sockets through a Reactor (epoll on Linux), so a bot is serviced as soon
+// as its broadcast arrives whatever its descriptor number. Prints
+// throughput once a second and the command-to-broadcast latency
+// percentiles at the end.
+namespace {
+constexpr std::size_t botsPerWorker = 500;
+constexpr auto sweepInterval = std::chrono::milliseconds(50);
+
+void runWorker(std::vector<std::unique_ptr<LoadBot>>& bots, LoadStats& stats, const std::atomic<bool>& stop) {
+    auto reactor = Reactor::create();
+    std::vector<LoadBot*> offline;
+
+    // A socket the reactor cannot watch would only be serviced by the sweep,
+    // adding up to sweepInterval to every latency it records. Such a bot is
+    // retired and counted instead of skewing the percentiles.
+    auto connect = [&](LoadBot* b) {
+        if (!b->connect()) return false;
+        if (!reactor->add(b->getSocket(), b)) {
+            stats.unwatched.fetch_add(1, std::memory_order_relaxed);
+            b->disconnect();
+        }
+        return true;
+    };
+    auto retire = [&](LoadBot* b) {
+        reactor->remove(b->getSocket());
+        b->disconnect();
+        offline.push_back(b);
+    };
+
+    for (auto& b : bots) {
+        if (!connect(b.get())) offline.push_back(b.get());
+    }
+
+    std::vector<Reactor::Ready> ready;
+    auto lastSweep = LoadBot::Clock::now();
+    while (!stop.load(std::memory_order_relaxed)) {
+        auto untilSweep = std::chrono::duration_cast<std::chrono::milliseconds>(sweepInterval - (LoadBot::Clock::now() - lastSweep));
+        reactor->wait((int)std::max<std::int64_t>(untilSweep.count(), 0), ready);
+        auto now = LoadBot::Clock::now();
+
+        for (const auto& r : ready) {
+            auto* b = static_cast<LoadBot*>(r.token);
+            if (b->isConnected() && !b->service(now)) retire(b);
+        }
+
+        // Every bot gets a look at least every sweepInterval for lobby and stall timers
+        if (now - lastSweep >= sweepInterval) {
+            lastSweep = now;
+            for (auto& b : bots) {
+                if (b->isConnected() && !b->service(now)) retire(b.get());
+            }
+        }
+
+        // Reconnect in the same pass; a refused connect is retried on the next one
+        std::vector<LoadBot*> retry;
+        for (LoadBot* b : offline) {
+            if (!connect(b)) retry.push_back(b);
+        }
+        offline.swap(retry);
+    }
+    for (auto& b : bots) b->disconnect();
+}
+
+void printPercentiles(const char* label, std::vector<std::uint32_t>& us) {
+    if (us.empty()) {
+        std::printf("  %-6s       no samples\n", label);
+        return;
+    }
+    auto at = [&](double q) {
+        std::size_t i = std::min(us.size() - 1, (std::size_t)(q * us.size()));
+        std::nth_element(us.begin(), us.begin() + i, us.end());
+        return us[i] / 1000.0;
+    };
+    std::printf("  %-6s %9zu  p50 %8.3f ms  p99 %8.3f ms  p999 %8.3f ms\n",
+        label, us.size(), at(0.50), at(0.99), at(0.999));
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t botCount = argc > 1 ? (std::size_t)std::stoul(argv[1]) : 1000;
+    unsigned seconds = argc > 2 ? (unsigned)std::stoul(argv[2]) : 30;
+    LoadConfig config;
+    if (argc > 3) config.host = argv[3];
+    if (argc > 4) config.port = (unsigned short)std::stoul(argv[4]);
+    if (argc > 5) config.tableSize = std::max<std::size_t>(2, std::stoul(argv[5]));
+
+    std::size_t workers = std::max<std::size_t>(1, (botCount + botsPerWorker - 1) / botsPerWorker);
+    workers = std::max<std::size_t>(workers, std::min<std::size_t>(botCount, std::max(1u, std::thread::hardware_concurrency() / 2)));
+
+    std::cout << "PerudoLoadGen: " << botCount << " bots on " << workers << " threads against "
+              << config.host << ":" << config.port << " for " << seconds << " s, "
+              << config.tableSize << " players per table\n";
+
+    std::vector<LoadStats> stats(workers);
+    std::vector<std::vector<std::unique_ptr<LoadBot>>> bots(workers);
+    for (std::size_t i = 0; i < botCount; ++i) {
+        std::size_t w = i % workers;
+        bots[w].push_back(std::make_unique<LoadBot>("bot" + std::to_string(i), config, stats[w]));
+    }
+
+    std::atomic<bool> stop{ false };
+    std::vector<std::thread> threads;
+    for (std::size_t w = 0; w < workers; ++w)
+        threads.emplace_back(runWorker, std::ref(bots[w]), std::ref(stats[w]), std::cref(stop));
+
+    auto total = [&](std::atomic<std::uint64_t> LoadStats::* field) {
+        std::uint64_t sum = 0;
+        for (auto& s : stats) sum += (s.*field).load(std::memory_order_relaxed);
+        return sum;
+    };
+
+    std::uint64_t lastGames = 0, lastMessages = 0, lastCommands = 0;
+    for (unsigned t = 1; t <= seconds; ++t) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::uint64_t games = total(&LoadStats::games);
+        std::uint64_t messages = total(&LoadStats::messages);
+        std::uint64_t commands = total(&LoadStats::commands);
+        std::printf("[%3us] games/s %6llu  msgs/s %9llu  cmds/s %8llu  connects %llu  rejects %llu  stalls %llu\n", t,
+            (unsigned long long)(games - lastGames), (unsigned long long)(messages - lastMessages),
+            (unsigned long long)(commands - lastCommands), (unsigned long long)total(&LoadStats::connects),
+            (unsigned long long)total(&LoadStats::rejects), (unsigned long long)total(&LoadStats::stalls));
+        std::fflush(stdout);
+        lastGames = games; lastMessages = messages; lastCommands = commands;
+    }
+
+    stop = true;
+    for (auto& t : threads) t.join();
+
+    double secs = seconds > 0 ? seconds : 1;
+    std::printf("Total: %llu games (%.1f/s), %llu messages (%.0f/s), %llu commands\n",
+        (unsigned long long)lastGames, lastGames / secs, (unsigned long long)lastMessages, lastMessages / secs,
+        (unsigned long long)lastCommands);
+    if (std::uint64_t unwatched = total(&LoadStats::unwatched))
+        std::printf("Warning: %llu bots retired, their sockets could not be watched (too many for this platform's selector)\n",
+            (unsigned long long)unwatched);
+    std::printf("Latency, command sent to broadcast received:\n");
+    std::vector<std::uint32_t> all;
+    for (std::size_t c = 0; c < commandKinds; ++c) {
+        std::vector<std::uint32_t> samples;
+        for (auto& s : stats) samples.insert(samples.end(), s.latencyUs[c].begin(), s.latencyUs[c].end());
+        all.insert(all.end(), samples.begin(), samples.end());
+        printPercentiles(commandName((Command)c), samples);
+    }
+    printPercentiles("all", all);
+    return 0;
+}
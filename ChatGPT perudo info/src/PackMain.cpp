@@ -0,0 +1,90 @@
+#include "AssetPack.h"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Builds the client's asset pack:
+//   PerudoPack assets/perudo.pack assets/dice/die1.png ... assets/fonts/OpenSans-Regular.ttf
+// Run it from the directory the game runs in; each entry is named by the
+// path given here, which is the path the game asks for. Images are stored
+// decoded to RGBA, everything else byte for byte.
+namespace {
+bool isImage(const std::string& path) {
+    std::string ext = path.substr(path.find_last_of('.') + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext == "png" || ext == "jpg" || ext == "jpeg" || ext == "bmp" || ext == "tga";
+}
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: PerudoPack <out.pack> <file>...\n";
+        return 1;
+    }
+
+    std::vector<AssetPack::Entry> entries;
+    std::vector<std::vector<char>> blobs;
+    for (int i = 2; i < argc; ++i) {
+        std::string path = argv[i];
+        AssetPack::Entry e{};
+        if (path.size() >= sizeof(e.name)) {
+            std::cerr << "Error: name too long: " << path << "\n";
+            return 1;
+        }
+        std::strncpy(e.name, path.c_str(), sizeof(e.name) - 1);
+
+        std::vector<char> bytes;
+        sf::Image image;
+        if (isImage(path) && image.loadFromFile(path)) {
+            e.kind = AssetPack::Kind::Rgba;
+            e.width = image.getSize().x;
+            e.height = image.getSize().y;
+            const char* px = reinterpret_cast<const char*>(image.getPixelsPtr());
+            bytes.assign(px, px + std::size_t(e.width) * e.height * 4);
+        }
+        else {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                std::cerr << "Error: could not read " << path << "\n";
+                return 1;
+            }
+            e.kind = AssetPack::Kind::File;
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        e.size = bytes.size();
+        entries.push_back(e);
+        blobs.push_back(std::move(bytes));
+    }
+
+    // Lay the blobs out after the index, each on an aligned offset
+    auto align = [](sf::Uint64 n) { return (n + AssetPack::alignment - 1) / AssetPack::alignment * AssetPack::alignment; };
+    sf::Uint64 offset = align(sizeof(AssetPack::Header) + entries.size() * sizeof(AssetPack::Entry));
+    for (auto& e : entries) {
+        e.offset = offset;
+        offset = align(offset + e.size);
+    }
+
+    std::ofstream out(argv[1], std::ios::binary);
+    AssetPack::Header header{};
+    std::memcpy(header.magic, "PRDOPACK", 8);
+    header.version = AssetPack::Version;
+    header.count = (sf::Uint32)entries.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetPack::Entry));
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        out.seekp((std::streamoff)entries[i].offset);
+        out.write(blobs[i].data(), blobs[i].size());
+    }
+    if (!out) {
+        std::cerr << "Error: could not write " << argv[1] << "\n";
+        return 1;
+    }
+    std::cout << "PerudoPack: wrote " << entries.size() << " entries to " << argv[1] << "\n";
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "Reactor.h"
+#include "SocketHandle.h"
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+namespace {
+
+// ---- Portable fallback: level-triggered, still walks every socket ----
+// SocketSelector cannot be interrupted, so waits are capped instead.
+class SelectorReactor : public Reactor {
+public:
+    bool add(sf::Socket& socket, void* token) override {
+        // SocketSelector drops, with only a log line, sockets select() cannot
+        // hold: more than FD_SETSIZE of them on Windows, and descriptors
+        // numbered FD_SETSIZE or above elsewhere. Refuse those here instead.
+#ifdef _WIN32
+        if (tokens.size() >= FD_SETSIZE) return false;
+#else
+        if (SocketHandleAccess::of(socket) >= FD_SETSIZE) return false;
+#endif
+        selector.add(socket);
+        tokens[&socket] = token;
+        return true;
+    }
+
+    void remove(sf::Socket& socket) override {
+        selector.remove(socket);
+        tokens.erase(&socket);
+    }
+
+    void wait(int timeoutMs, std::vector<Ready>& ready) override {
+        ready.clear();
+        if (timeoutMs < 0 || timeoutMs > maxWaitMs) timeoutMs = maxWaitMs;
+        if (!selector.wait(sf::milliseconds(std::max(timeoutMs, 1)))) return;
+        for (auto& kv : tokens) {
+            if (selector.isReady(*kv.first)) ready.push_back({ kv.second, Readable });
+        }
+    }
+
+    void wake() override {}
+
+    bool reportsWritable() const override { return false; }
+    bool edgeTriggered() const override { return false; }
+
+private:
+    static constexpr int maxWaitMs = 10;
+    sf::SocketSelector selector;
+    std::unordered_map<sf::Socket*, void*> tokens;
+};
+
+#ifdef __linux__
+// ---- Linux: edge-triggered epoll, cost proportional to ready sockets ----
+class EpollReactor : public Reactor {
+public:
+    EpollReactor()
+        : epfd(epoll_create1(EPOLL_CLOEXEC)),
+          wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+          events(256) {
+        if (epfd < 0 || wakeFd < 0) return;
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.ptr = &wakeFd;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, wakeFd, &ev);
+    }
+    ~EpollReactor() override {
+        if (wakeFd >= 0) close(wakeFd);
+        if (epfd >= 0) close(epfd);
+    }
+
+    bool valid() const { return epfd >= 0 && wakeFd >= 0; }
+
+    bool add(sf::Socket& socket, void* token) override {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = token;
+        return epoll_ctl(epfd, EPOLL_CTL_ADD, SocketHandleAccess::of(socket), &ev) == 0;
+    }
+
+    void remove(sf::Socket& socket) override {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, SocketHandleAccess::of(socket), nullptr);
+    }
+
+    void wait(int timeoutMs, std::vector<Ready>& ready) override {
+        ready.clear();
+        int n = epoll_wait(epfd, events.data(), (int)events.size(), timeoutMs);
+        if (n < 0) {
+            if (errno != EINTR) std::cerr << "Reactor: epoll_wait failed (" << errno << ")\n";
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.ptr == &wakeFd) {
+                eventfd_t drained;
+                eventfd_read(wakeFd, &drained);
+                continue;
+            }
+            unsigned e = 0;
+            // hang-ups and errors surface as a failed receive
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) e |= Readable;
+            if (events[i].events & EPOLLOUT) e |= Writable;
+            ready.push_back({ events[i].data.ptr, e });
+        }
+        if (n == (int)events.size()) events.resize(events.size() * 2);
+    }
+
+    void wake() override { eventfd_write(wakeFd, 1); }
+
+    bool reportsWritable() const override { return true; }
+    bool edgeTriggered() const override { return true; }
+
+private:
+    int epfd;
+    int wakeFd;
+    std::vector<epoll_event> events;
+};
+#endif
+
+} // namespace
+
+std::unique_ptr<Reactor> Reactor::create() {
+#ifdef __linux__
+    auto epoll = std::make_unique<EpollReactor>();
+    if (epoll->valid()) return epoll;
+    std::cerr << "Reactor: epoll unavailable, falling back to SocketSelector\n";
+#endif
+    return std::make_unique<SelectorReactor>();
+}
@@ -1,3 +1,93 @@
 #include "ResourceManager.h"
+#include <algorithm>
+#include <cmath>
 
-std::map<std::string, std::unique_ptr<sf::Texture>> ResourceManager::textures;
\ No newline at end of file
+TextureCache ResourceManager::textures;
+std::unique_ptr<sf::Texture> ResourceManager::atlas;
+std::map<std::string, AtlasRegion> ResourceManager::regions;
+
+void ResourceManager::buildAtlas(const std::vector<std::pair<std::string, std::string>>& files) {
+    PackedAtlas packed = packAtlas(files);
+    auto texture = std::make_unique<sf::Texture>();
+    if (!texture->loadFromImage(packed.sheet)) std::cerr << "Error: could not create atlas texture" << std::endl;
+    installAtlas(std::move(texture), packed.rects);
+}
+
+bool ResourceManager::loadImage(sf::Image& image, const std::string& filename, const AssetPack* pack) {
+    AssetPack::Blob blob;
+    if (!pack || !pack->find(filename, blob)) return image.loadFromFile(filename);
+    if (blob.kind == AssetPack::Kind::Rgba) {
+        image.create(blob.width, blob.height, static_cast<const sf::Uint8*>(blob.data));
+        return true;
+    }
+    return image.loadFromMemory(blob.data, blob.size);
+}
+
+PackedAtlas ResourceManager::packAtlas(const std::vector<std::pair<std::string, std::string>>& files, const AssetPack* pack) {
+    const unsigned padding = 2; // keeps filtering from bleeding between neighbours
+
+    std::vector<sf::Image> images(files.size());
+    unsigned widest = 0;
+    double area = 0;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        if (!loadImage(images[i], files[i].second, pack)) {
+            std::cerr << "Error: could not load texture " << files[i].second << std::endl;
+            images[i].create(64, 64, sf::Color::Transparent); // keeps the layout intact
+        }
+        sf::Vector2u size = images[i].getSize();
+        widest = std::max(widest, size.x + padding);
+        area += double(size.x + padding) * (size.y + padding);
+    }
+
+    // Shelf packing, tallest first: fill rows left to right up to a roughly
+    // square width, then start a new row below the tallest image so far.
+    std::vector<std::size_t> order(files.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return images[a].getSize().y > images[b].getSize().y;
+    });
+
+    unsigned width = std::max(widest, (unsigned)std::ceil(std::sqrt(area)));
+    unsigned x = 0, y = 0, rowHeight = 0, usedWidth = 0;
+    std::vector<sf::Vector2u> where(files.size());
+    for (std::size_t i : order) {
+        sf::Vector2u size = images[i].getSize();
+        if (x + size.x + padding > width) {
+            x = 0;
+            y += rowHeight;
+            rowHeight = 0;
+        }
+        where[i] = { x, y };
+        x += size.x + padding;
+        usedWidth = std::max(usedWidth, x);
+        rowHeight = std::max(rowHeight, size.y + padding);
+    }
+    width = usedWidth;
+    unsigned height = y + rowHeight;
+
+    PackedAtlas packed;
+    packed.sheet.create(std::max(width, 1u), std::max(height, 1u), sf::Color::Transparent);
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        sf::Vector2u size = images[i].getSize();
+        packed.sheet.copy(images[i], where[i].x, where[i].y);
+        packed.rects[files[i].first] = sf::IntRect((int)where[i].x, (int)where[i].y, (int)size.x, (int)size.y);
+    }
+    std::cout << "Atlas: packed " << files.size() << " images into " << width << "x" << height << std::endl;
+    return packed;
+}
+
+void ResourceManager::installAtlas(std::unique_ptr<sf::Texture> texture, const std::map<std::string, sf::IntRect>& rects) {
+    atlas = std::move(texture);
+    regions.clear();
+    for (auto& kv : rects) regions[kv.first] = { atlas.get(), kv.second };
+}
+
+const AtlasRegion& ResourceManager::getRegion(const std::string& name) {
+    auto it = regions.find(name);
+    if (it != regions.end()) return it->second;
+
+    std::cerr << "Error: no atlas region " << name << std::endl;
+    static sf::Texture dummy; // fallback
+    static AtlasRegion none{ &dummy, sf::IntRect() };
+    return none;
+}
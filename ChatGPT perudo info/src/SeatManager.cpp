@@ -1,25 +1,59 @@
 #include "SeatManager.h"
+#include <algorithm>
 #include <cmath>
 
+unit_circle::Point unit_circle::at(int index, int count) {
+    if (count <= maxPoints) return tables.points[count][index];
+    double angle = index * (2 * pi / count) - pi / 2;
+    return { (float)std::cos(angle), (float)std::sin(angle) };
+}
+
 SeatManager::SeatManager(float windowWidth, float windowHeight)
     : winW(windowWidth), winH(windowHeight) {
 }
 
+void SeatManager::setWindowSize(float windowWidth, float windowHeight) {
+    if (windowWidth == winW && windowHeight == winH) return;
+    winW = windowWidth;
+    winH = windowHeight;
+    layouts.clear();
+}
+
+const SeatLayout& SeatManager::layout(int totalPlayers, int dicePerPlayer) {
+    totalPlayers = std::max(totalPlayers, 1);
+    dicePerPlayer = std::max(dicePerPlayer, 1);
+    auto key = std::make_tuple(totalPlayers, dicePerPlayer);
+    auto it = layouts.find(key);
+    if (it != layouts.end()) return it->second;
+
+    SeatLayout& l = layouts[key];
+    l.players = totalPlayers;
+    l.dice = dicePerPlayer;
+    for (int p = 0; p < totalPlayers; ++p) l.seats.push_back(computeSeat(p, totalPlayers));
+
+    l.diceSpots.reserve((std::size_t)totalPlayers * dicePerPlayer * dicePerPlayer);
+    for (int p = 0; p < totalPlayers; ++p) {
+        float r = p == 0 ? myDiceRadius : opponentDiceRadius;
+        for (int count = 1; count <= dicePerPlayer; ++count) {
+            for (int i = 0; i < dicePerPlayer; ++i) {
+                unit_circle::Point u = unit_circle::at(std::min(i, count - 1), count);
+                l.diceSpots.push_back({ l.seats[p].x + r * u.x, l.seats[p].y + r * u.y });
+            }
+        }
+    }
+    return l;
+}
+
 // Seats:
 // 0 = you (bottom center)
 // others arranged clockwise around "table"
-sf::Vector2f SeatManager::getSeatPosition(int playerIndex, int totalPlayers) {
+sf::Vector2f SeatManager::computeSeat(int playerIndex, int totalPlayers) const {
     if (playerIndex == 0) {
         return sf::Vector2f(winW / 2.f, winH - 150.f); // bottom center
     }
 
     // Circle around table
     float radius = std::min(winW, winH) / 2.5f;
-    float angleStep = 2 * 3.14159f / (totalPlayers - 1);
-
-    float angle = (playerIndex - 1) * angleStep - 3.14159f / 2.f;
-    float x = winW / 2.f + radius * std::cos(angle);
-    float y = winH / 2.f + radius * std::sin(angle);
-
-    return sf::Vector2f(x, y);
+    unit_circle::Point u = unit_circle::at(playerIndex - 1, totalPlayers - 1);
+    return sf::Vector2f(winW / 2.f + radius * u.x, winH / 2.f + radius * u.y);
 }
@@ -1,9 +1,22 @@
 #include "Server.h"
 #include <iostream>
+#include <random>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    // Optional: number of worker threads (default: one per core), the
+    // send-queue report interval in seconds (default: off) and the dice
+    // seed (default: random; logged either way so games can be replayed)
+    unsigned threads = argc > 1 ? (unsigned)std::stoul(argv[1]) : 0;
+    unsigned statsInterval = argc > 2 ? (unsigned)std::stoul(argv[2]) : 0;
+    std::uint64_t diceSeed = argc > 3 ? std::stoull(argv[3])
+                                      : ((std::uint64_t)std::random_device{}() << 32) ^ std::random_device{}();
 
-int main() {
     std::cout << "Starting Perudo server on port 54000...\n";
+    std::cout << "Server: dice seed " << diceSeed << " (table N rolls stream N)\n";
     Server server;
-    server.start(54000);
+    server.setStatsInterval(statsInterval);
+    server.setDiceSeed(diceSeed);
+    server.start(54000, threads);
     return 0;
 }
@@ -0,0 +1,366 @@
+#include "Shard.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+namespace {
+// Peers must be this many connections busier before we take a table
+constexpr std::size_t stealThreshold = 16;
+// How often a shard holding tables compares its load with its peers'
+constexpr auto balanceInterval = std::chrono::milliseconds(250);
+}
+
+Shard::Shard(int index, int shardCount, std::size_t seatsPerTable, std::uint64_t diceSeed)
+    : index(index),
+      reactor(Reactor::create()),
+      tables(seatsPerTable, index + 1, shardCount, diceSeed) {
+}
+
+Shard::~Shard() {
+    if (thread.joinable()) thread.detach(); // the server runs until the process exits
+}
+
+void Shard::start() {
+    thread = std::thread([this] { run(); });
+}
+
+void Shard::adopt(std::unique_ptr<sf::TcpSocket> socket) {
+    auto conn = std::make_unique<Connection>();
+    conn->socket = std::move(socket);
+    connectionCount.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        inboxConnections.push_back(std::move(conn));
+    }
+    reactor->wake();
+}
+
+void Shard::post(TableTransfer transfer) {
+    connectionCount.fetch_add(transfer.seated.size(), std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        inboxTables.push_back(std::move(transfer));
+    }
+    reactor->wake();
+}
+
+void Shard::post(Shard* thief) {
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        inboxStealRequests.push_back(thief);
+    }
+    reactor->wake();
+}
+
+std::future<std::vector<Shard::QueueStat>> Shard::requestQueueStats() {
+    std::promise<std::vector<QueueStat>> request;
+    auto answer = request.get_future();
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        inboxStatsRequests.push_back(std::move(request));
+    }
+    reactor->wake();
+    return answer;
+}
+
+void Shard::run() {
+    std::vector<Reactor::Ready> ready;
+    nextBalance = Clock::now() + balanceInterval;
+    while (true) {
+        // Timers: slow-consumer deadlines and the periodic balance check;
+        // with neither, the wait has no timeout
+        reactor->wait(msUntilNextTimer(), ready);
+
+        for (auto& r : ready) {
+            auto* conn = static_cast<Connection*>(r.token);
+            if (r.events & Reactor::Writable) flushConnection(conn);
+            if (r.events & Reactor::Readable) serviceClient(conn);
+        }
+        flushBacklog();
+
+        // Deferred so tokens later in `ready` never dangle
+        dropClosed();
+
+        // Handoffs wait until `ready` is consumed so that a table given
+        // away never has sockets pending in this batch.
+        drainInbox();
+
+        // Rebalance even when no connection closes anywhere. Only shards
+        // with tables tick: the busy one pushes, so an idle one can sleep.
+        if (!balancing()) nextBalance = Clock::now() + balanceInterval;
+        else if (Clock::now() >= nextBalance) {
+            nextBalance = Clock::now() + balanceInterval;
+            shedLoad();
+        }
+    }
+}
+
+void Shard::drainInbox() {
+    std::vector<std::unique_ptr<Connection>> newConnections;
+    std::vector<TableTransfer> newTables;
+    std::vector<Shard*> stealRequests;
+    std::vector<std::promise<std::vector<QueueStat>>> statsRequests;
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        newConnections.swap(inboxConnections);
+        newTables.swap(inboxTables);
+        stealRequests.swap(inboxStealRequests);
+        statsRequests.swap(inboxStatsRequests);
+    }
+
+    for (auto& request : statsRequests) request.set_value(queueStats());
+
+    for (auto& conn : newConnections) watch(std::move(conn));
+
+    for (auto& transfer : newTables) {
+        std::cout << "Server: shard " << index << " took table " << transfer.table->getId() << "\n";
+        tables.adopt(std::move(transfer.table));
+        for (auto& conn : transfer.seated) watch(std::move(conn));
+        stealPending = false;
+    }
+
+    // Sockets that failed on arrival must go before any table is given away
+    dropClosed();
+    for (auto* thief : stealRequests) giveTablesTo(thief);
+
+    // Still far behind after a handoff: ask again rather than wait a tick
+    if (!newTables.empty()) maybeSteal();
+}
+
+void Shard::watch(std::unique_ptr<Connection> conn) {
+    Connection* raw = conn.get();
+    if (!reactor->add(*raw->socket, raw)) {
+        std::cerr << "Server: shard " << index << " could not watch client\n";
+        if (raw->table) tables.unseat(raw);
+        connectionCount.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    clients[raw] = std::move(conn);
+    if (raw->queuedBytes() > 0) backlogged.insert(raw);
+    // Data that arrived while the socket was in transit
+    if (reactor->edgeTriggered()) serviceClient(raw);
+}
+
+void Shard::serviceClient(Connection* client) {
+    if (client->closing) return;
+    if (!handleClientMessages(client)) markClosed(client);
+}
+
+// Everything one inbound message produced leaves in one write per socket.
+void Shard::flushTable(Connection* client) {
+    flushConnection(client);
+    if (!client->table) return;
+    for (auto* seat : client->table->getSeats()) {
+        if (seat != client) flushConnection(seat);
+    }
+}
+
+void Shard::flushConnection(Connection* client) {
+    if (client->closing) return;
+    if (!client->flush()) {
+        markClosed(client);
+        return;
+    }
+    if (client->isSlowConsumer()) {
+        std::cout << "Server: evicting slow consumer (" << client->queuedBytes() << " B queued, peak "
+                  << client->peakQueuedBytes() << " B)\n";
+        markClosed(client);
+        return;
+    }
+    if (client->queuedBytes() > 0) backlogged.insert(client);
+    else backlogged.erase(client);
+}
+
+// Retries queued output that no Writable event will announce, and evicts
+// consumers whose stall deadline has passed.
+void Shard::flushBacklog() {
+    if (backlogged.empty()) return;
+    std::vector<Connection*> pending(backlogged.begin(), backlogged.end());
+    for (auto* conn : pending) {
+        if (!reactor->reportsWritable() || conn->isSlowConsumer()) flushConnection(conn);
+    }
+}
+
+int Shard::msUntilNextTimer() const {
+    int timeout = -1; // none
+    if (balancing()) {
+        auto untilBalance = std::chrono::duration_cast<std::chrono::milliseconds>(nextBalance - Clock::now());
+        timeout = (int)std::max<long long>(untilBalance.count(), 0);
+    }
+    for (auto* conn : backlogged) {
+        int t = conn->msUntilStalled();
+        if (t >= 0 && (timeout < 0 || t < timeout)) timeout = t;
+    }
+    return timeout;
+}
+
+bool Shard::balancing() const {
+    return peers.size() > 1 && tables.tableCount() > 0;
+}
+
+void Shard::markClosed(Connection* client) {
+    if (client->closing) return;
+    client->closing = true;
+    closed.push_back(client);
+}
+
+void Shard::dropClosed() {
+    if (closed.empty()) return;
+    // Indexed: flushing the leaver's table can close more connections
+    for (std::size_t i = 0; i < closed.size(); ++i) dropClient(closed[i]);
+    closed.clear();
+    maybeSteal();
+}
+
+void Shard::dropClient(Connection* client) {
+    reactor->remove(*client->socket);
+    if (client->table) {
+        // The rest of the table has just been told; send it now
+        std::vector<Connection*> others = client->table->getSeats();
+        tables.unseat(client);
+        for (auto* seat : others) {
+            if (seat != client) flushConnection(seat);
+        }
+    }
+    else std::cout << "Server: disconnected before HELLO\n";
+    backlogged.erase(client);
+    clients.erase(client);
+    connectionCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool Shard::handleClientMessages(Connection* client) {
+    // Drain everything buffered: the reactor may be edge-triggered.
+    while (true) {
+        sf::Packet p;
+        auto s = client->socket->receive(p);
+        if (s == sf::Socket::NotReady) return true;
+        if (s != sf::Socket::Done) return false; // Disconnected / Error
+        if (!handleClientMessage(client, p)) return false;
+        flushTable(client);
+        if (client->closing) return true;
+    }
+}
+
+bool Shard::handleClientMessage(Connection* client, sf::Packet& p) {
+    if (proto::isBinary(p)) return handleBinaryMessage(client, p);
+
+    std::string line;
+    if (!(p >> line)) return true;
+
+    // PROTO may precede HELLO; it switches the replies to binary. Older
+    // binary versions are not spoken any more and fall back to text.
+    if (line.rfind("PROTO ", 0) == 0) {
+        int wanted = std::atoi(line.c_str() + 6);
+        client->protocol = wanted >= proto::Version ? proto::Version : 0;
+        client->sendLine("PROTO " + std::to_string(client->protocol));
+        return true;
+    }
+
+    // HELLO seats the connection; everything else belongs to its table.
+    if (line.rfind("HELLO ", 0) == 0) {
+        std::string name = line.substr(6);
+        if (client->table) client->table->join(client, name);
+        else tables.seat(client, name);
+        return true;
+    }
+
+    Table* table = client->table;
+    if (!table) return true;
+
+    if (line == "ROLL") table->onRoll(client);
+    else if (line.rfind("BET ", 0) == 0) {
+        std::istringstream iss(line.substr(4));
+        int count, face;
+        if (iss >> count >> face) table->onBet(client, count, face);
+    }
+    else if (line == "DOUBT") table->onDoubt(client);
+    else if (line == "NEXT") table->onNext();
+    return true;
+}
+
+bool Shard::handleBinaryMessage(Connection* client, sf::Packet& p) {
+    Table* table = client->table;
+    if (!table) return true;
+
+    switch (proto::opcode(p)) {
+    case proto::Op::Roll:  table->onRoll(client); break;
+    case proto::Op::Doubt: table->onDoubt(client); break;
+    case proto::Op::Next:  table->onNext(); break;
+    case proto::Op::Resync: table->sendSnapshot(client); break;
+    case proto::Op::Bet: {
+        proto::Bet bet;
+        if (proto::decode(p, bet)) table->onBet(client, bet.count, bet.face);
+        break;
+    }
+    default: break; // not a client -> server message
+    }
+    return true;
+}
+
+// ---- Work stealing ----
+void Shard::maybeSteal() {
+    if (stealPending) return;
+    Shard* busiest = nullptr;
+    for (auto* peer : peers) {
+        if (peer == this) continue;
+        if (!busiest || peer->load() > busiest->load()) busiest = peer;
+    }
+    if (!busiest || busiest->load() < load() + stealThreshold) return;
+
+    stealPending = true;
+    busiest->post(this);
+}
+
+// The periodic half: a shard with tables gives some straight to its
+// lightest peer, which may be asleep with nothing to steal for
+void Shard::shedLoad() {
+    Shard* lightest = nullptr;
+    for (auto* peer : peers) {
+        if (peer == this) continue;
+        if (!lightest || peer->load() < lightest->load()) lightest = peer;
+    }
+    if (lightest && load() >= lightest->load() + stealThreshold) giveTablesTo(lightest);
+}
+
+// Hands over tables until the gap is under the threshold, largest first.
+// Each table that fits in half the gap narrows it without overshooting.
+void Shard::giveTablesTo(Shard* thief) {
+    bool gave = false;
+    for (;;) {
+        std::size_t mine = load(), theirs = thief->load();
+        Table* table = (mine >= theirs + stealThreshold) ? tables.findMovable((mine - theirs) / 2) : nullptr;
+        if (!table || table->playerCount() == 0) break;
+
+        TableTransfer transfer;
+        for (auto* conn : table->getSeats()) {
+            reactor->remove(*conn->socket);
+            backlogged.erase(conn);
+            auto it = clients.find(conn);
+            transfer.seated.push_back(std::move(it->second));
+            clients.erase(it);
+        }
+        connectionCount.fetch_sub(transfer.seated.size(), std::memory_order_relaxed);
+        transfer.table = tables.release(table->getId());
+        thief->post(std::move(transfer)); // raises thief->load() right away
+        gave = true;
+    }
+    if (!gave) thief->stealPending = false; // nothing worth moving; let it ask again later
+}
+
+// ---- Monitoring ----
+std::vector<Shard::QueueStat> Shard::queueStats() const {
+    std::vector<QueueStat> stats;
+    stats.reserve(clients.size());
+    for (auto& kv : clients) {
+        const Connection* c = kv.first;
+        QueueStat st;
+        st.shard = index;
+        st.table = c->table ? c->table->getId() : 0;
+        st.player = c->table ? c->table->nameOf(kv.first) : std::string();
+        st.queued = c->queuedBytes();
+        st.peak = c->peakQueuedBytes();
+        stats.push_back(std::move(st));
+    }
+    return stats;
+}
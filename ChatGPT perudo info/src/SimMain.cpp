@@ -0,0 +1,242 @@
+#include "Simulator.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Offline simulator: PerudoSim [mode] [args...]
+//
+//   games [games] [players] [rules] [seed] [threads]
+//       Plays complete games on every core and prints bid outcome rates,
+//       game lengths and win rates by seat.
+//
+//   count [dice] [iterations]
+//       Times countMatching over a table of `dice` dice: the old map of
+//       int vectors with a branch per die, each DicePool scanning kernel,
+//       and the per-round tally with the lookups it makes possible.
+//
+//   rng [dice] [rounds]
+//       Times rolling `dice` dice per round: mt19937 with a distribution
+//       per die (the server's old roll), and DiceRng per die and batched,
+//       with a chi-square check that the faces come out uniform.
+//
+// Work is cut into fixed chunks of games and chunk i always draws from
+// DiceRng stream i of the seed, so a run is reproducible from its seed
+// whatever the thread count or scheduling.
+namespace {
+constexpr std::uint64_t gamesPerChunk = 1024;
+
+using Clock = std::chrono::steady_clock;
+
+template <class R>
+sim::SimStats runGames(const sim::SimConfig& config, std::uint64_t games, std::uint64_t seed, unsigned threads) {
+    std::uint64_t chunks = (games + gamesPerChunk - 1) / gamesPerChunk;
+    std::atomic<std::uint64_t> nextChunk{ 0 };
+    std::vector<sim::SimStats> perThread(threads);
+
+    auto worker = [&](unsigned t) {
+        sim::SimGame<R> game(config);
+        sim::SimStats& stats = perThread[t];
+        for (;;) {
+            std::uint64_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunks) break;
+            perudo::DiceRng rng(seed, chunk);
+            std::uint64_t n = std::min(gamesPerChunk, games - chunk * gamesPerChunk);
+            for (std::uint64_t g = 0; g < n; ++g) game.play(rng, stats);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker, t);
+    for (auto& th : pool) th.join();
+
+    sim::SimStats total;
+    for (auto& s : perThread) total.merge(s);
+    return total;
+}
+
+double percent(std::uint64_t part, std::uint64_t whole) {
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+void printGames(const sim::SimStats& s, int players, double seconds) {
+    std::printf("Games    %llu in %.2f s: %.0f games/s, %.0f rounds/s\n",
+        (unsigned long long)s.games, seconds, s.games / seconds, s.rounds / seconds);
+    std::printf("Rounds   %.2f per game (min %llu, max %llu)\n",
+        s.games ? (double)s.rounds / s.games : 0.0, (unsigned long long)s.minRounds, (unsigned long long)s.maxRounds);
+    std::printf("Bids     %.2f per round, %.1f%% on ones\n",
+        s.rounds ? (double)s.bids / s.rounds : 0.0, percent(s.onesBids, s.bids));
+    std::printf("Doubts   bid stood %.1f%%, exactly right %.1f%%, palifico %.1f%%\n",
+        percent(s.bidsHeld, s.doubts), percent(s.exactBids, s.doubts), percent(s.palificoDoubts, s.doubts));
+    std::printf("Wins     ");
+    for (int p = 0; p < players; ++p) std::printf("seat %d: %.2f%%  ", p, percent(s.wins[p], s.games));
+    std::printf("\n");
+}
+
+// House-rule variants, one instantiation each
+template <class R>
+bool playVariant(const sim::SimConfig& config, std::uint64_t games, std::uint64_t seed, unsigned threads) {
+    auto start = Clock::now();
+    sim::SimStats stats = runGames<R>(config, games, seed, threads);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    printGames(stats, config.players, seconds);
+    return true;
+}
+
+bool playGames(const std::string& rules, const sim::SimConfig& config, std::uint64_t games, std::uint64_t seed, unsigned threads) {
+    if (rules == "standard")   return playVariant<perudo::StandardRules>(config, games, seed, threads);
+    if (rules == "nowild")     return playVariant<perudo::Rules<false, true>>(config, games, seed, threads);
+    if (rules == "openones")   return playVariant<perudo::Rules<true, true>>(config, games, seed, threads);
+    if (rules == "nopalifico") return playVariant<perudo::Rules<true, false, false>>(config, games, seed, threads);
+    if (rules == "party")      return playVariant<perudo::Rules<true, false, true, 20>>(config, games, seed, threads);
+    std::printf("Unknown rules '%s' (standard, nowild, openones, nopalifico, party)\n", rules.c_str());
+    return false;
+}
+
+// ---- count benchmark ----
+// The server's previous layout and loop, kept as the baseline
+int countMatchingMap(const std::map<std::string, std::vector<int>>& allDice, int betFace, bool palifico) {
+    int total = 0;
+    for (auto& kv : allDice) {
+        for (int d : kv.second) {
+            if (betFace == 1) { if (d == 1) total++; }
+            else if (palifico) { if (d == betFace) total++; }
+            else { if (d == betFace || d == 1) total++; }
+        }
+    }
+    return total;
+}
+
+template <class Count>
+void timeCount(const char* label, std::uint64_t iterations, std::size_t dice, Count&& count) {
+    auto start = Clock::now();
+    std::uint64_t checksum = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i)
+        checksum += (std::uint64_t)count((std::uint8_t)(i % 6 + 1), (i / 6) % 4 == 0); // every face, some palifico
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+    std::printf("  %-8s %9.1f ns/count  %7.2f dice/ns  (checksum %llu)\n",
+        label, ns, dice / ns, (unsigned long long)checksum);
+}
+
+int benchCount(std::size_t dice, std::uint64_t iterations) {
+    using R = perudo::StandardRules;
+    std::mt19937_64 rng(1);
+    std::uniform_int_distribution<int> d6(1, 6);
+
+    // Same dice in both layouts, in hands of five
+    std::map<std::string, std::vector<int>> byName;
+    perudo::DicePool pool;
+    for (std::size_t p = 0; p * 5 < dice; ++p) {
+        std::size_t n = std::min<std::size_t>(5, dice - p * 5);
+        std::uint8_t* hand = pool.add((std::uint8_t)p, n);
+        std::vector<int>& v = byName["player" + std::to_string(p)];
+        for (std::size_t i = 0; i < n; ++i) v.push_back(hand[i] = (std::uint8_t)d6(rng));
+    }
+
+    std::printf("PerudoSim count: %zu dice, %llu iterations, widest kernel %s\n",
+        dice, (unsigned long long)iterations, perudo::countFaceKernel());
+    timeCount("map", iterations, dice, [&](std::uint8_t f, bool pal) { return countMatchingMap(byName, f, pal); });
+    auto kernel = [&](auto fn) {
+        return [&, fn](std::uint8_t f, bool pal) { return fn(pool.data(), pool.size(), f, perudo::wildAlt<R>(f, pal)); };
+    };
+    timeCount("scalar", iterations, dice, kernel(perudo::countFaceScalar));
+#if defined(PERUDO_DICE_SSE2) || defined(PERUDO_DICE_AVX2)
+    timeCount("sse2", iterations, dice, kernel(perudo::countFaceSse2));
+#endif
+#if defined(PERUDO_DICE_AVX2)
+    timeCount("avx2", iterations, dice, kernel(perudo::countFaceAvx2));
+#endif
+
+    // A tally costs one pass per round; every count after it is a lookup
+    std::uint64_t tallies = std::max<std::uint64_t>(iterations / 10, 1);
+    auto start = Clock::now();
+    for (std::uint64_t i = 0; i < tallies; ++i) pool.tally();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / tallies;
+    std::printf("  %-8s %9.1f ns/round  (built once per roll)\n", "tally", ns);
+    timeCount("lookup", iterations, dice, [&](std::uint8_t f, bool pal) { return perudo::countMatching<R>(pool, f, pal); });
+    return 0;
+}
+
+// ---- rng benchmark ----
+template <class Roll>
+void timeRoll(const char* label, std::size_t dice, std::uint64_t rounds, Roll&& roll) {
+    std::vector<std::uint8_t> out(dice);
+    std::uint64_t sink = 0;
+    auto start = Clock::now();
+    for (std::uint64_t r = 0; r < rounds; ++r) {
+        roll(out.data(), dice);
+        sink += out[dice - 1];
+    }
+    double total = (double)dice * rounds;
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / total;
+
+    // Then as many dice again, untimed, for the face counts
+    perudo::FaceCounts faces{};
+    for (std::uint64_t r = 0; r < rounds; ++r) {
+        roll(out.data(), dice);
+        for (std::uint8_t d : out) ++faces[d <= 6 ? d : 0];
+    }
+    // Five degrees of freedom: above 20.5 happens by chance once in a thousand runs
+    double expected = total / 6, chi2 = 0;
+    for (int f = 1; f <= 6; ++f) chi2 += (faces[f] - expected) * (faces[f] - expected) / expected;
+    std::printf("  %-14s %6.2f ns/die  chi2 %6.2f%s  (sink %llu)\n",
+        label, ns, chi2, faces[0] ? "  invalid faces!" : "", (unsigned long long)sink);
+}
+
+int benchRng(std::size_t dice, std::uint64_t rounds) {
+    std::printf("PerudoSim rng: %zu dice per round, %llu rounds\n",
+        dice, (unsigned long long)rounds);
+    std::uniform_int_distribution<int> d6(1, 6);
+    auto perDie = [&](auto& rng) {
+        return [&](std::uint8_t* out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = (std::uint8_t)d6(rng); };
+    };
+    std::mt19937 mt(1);
+    std::mt19937_64 mt64(1);
+    perudo::DiceRng fast(1);
+    timeRoll("mt19937", dice, rounds, perDie(mt));
+    timeRoll("mt19937_64", dice, rounds, perDie(mt64));
+    timeRoll("DiceRng", dice, rounds, perDie(fast));
+    timeRoll("DiceRng rollD6", dice, rounds, [&](std::uint8_t* out, std::size_t n) { fast.rollD6(out, n); });
+    return 0;
+}
+
+int usage() {
+    std::printf("Usage: PerudoSim games [games] [players] [rules] [seed] [threads]\n"
+                "       PerudoSim count [dice] [iterations]\n"
+                "       PerudoSim rng [dice] [rounds]\n");
+    return 1;
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "games";
+    if (mode == "count") {
+        std::size_t dice = argc > 2 ? (std::size_t)std::stoul(argv[2]) : 40;
+        std::uint64_t iterations = argc > 3 ? std::stoull(argv[3]) : 10000000;
+        return benchCount(std::max<std::size_t>(dice, 1), std::max<std::uint64_t>(iterations, 1));
+    }
+    if (mode == "rng") {
+        std::size_t dice = argc > 2 ? (std::size_t)std::stoul(argv[2]) : 40;
+        std::uint64_t rounds = argc > 3 ? std::stoull(argv[3]) : 1000000;
+        return benchRng(std::max<std::size_t>(dice, 1), std::max<std::uint64_t>(rounds, 1));
+    }
+    if (mode != "games") return usage();
+
+    std::uint64_t games = argc > 2 ? std::stoull(argv[2]) : 1000000;
+    sim::SimConfig config;
+    if (argc > 3) config.players = std::clamp(std::stoi(argv[3]), 2, sim::maxSeats);
+    std::string rules = argc > 4 ? argv[4] : "standard";
+    std::uint64_t seed = argc > 5 ? std::stoull(argv[5])
+                                  : ((std::uint64_t)std::random_device{}() << 32) ^ std::random_device{}();
+    unsigned threads = argc > 6 ? (unsigned)std::stoul(argv[6]) : std::thread::hardware_concurrency();
+    threads = std::max(1u, threads);
+
+    // The seed is all it takes to replay a run
+    std::printf("PerudoSim: %llu games, %d players, %s rules, seed %llu, %u threads\n",
+        (unsigned long long)games, config.players, rules.c_str(), (unsigned long long)seed, threads);
+    return playGames(rules, config, games, seed, threads) ? 0 : 1;
+}
@@ -0,0 +1,390 @@
+﻿#include "Table.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+Table::Table(int id, std::size_t maxPlayers, std::uint64_t diceSeed)
+    : id(id), maxPlayers(maxPlayers), rng(diceSeed, (std::uint64_t)id) {
+}
+
+namespace {
+proto::Dice toDice(const perudo::DicePool& pool, const perudo::DicePool::Hand& hand) {
+    return proto::Dice(pool.begin(hand), pool.end(hand));
+}
+
+std::string diceCountLine(const Table::PlayerInfo& pi) {
+    return "DICECOUNT " + pi.name + ' ' + std::to_string(pi.diceCount);
+}
+}
+
+template <class Msg>
+void Table::send(Connection* c, const Msg& msg, const std::string& text) {
+    if (c->protocol) {
+        sf::Packet p; proto::encode(msg, p);
+        c->send(p);
+    }
+    else if (!text.empty()) {
+        c->sendLine(text);
+    }
+}
+
+template <class Msg>
+void Table::broadcast(const Msg& msg, const std::string& text) {
+    // Each wire form is framed at most once; every seat queues a reference
+    Frame binary, line;
+    for (auto* c : seats) {
+        if (c->protocol) {
+            if (!binary) { sf::Packet p; proto::encode(msg, p); binary = makeFrame(p); }
+            c->send(binary);
+        }
+        else if (!text.empty()) {
+            if (!line) { sf::Packet p; p << text; line = makeFrame(p); }
+            c->send(line);
+        }
+    }
+}
+
+template <class Msg>
+void Table::publish(Msg msg, const std::string& text) {
+    msg.seq = ++seq;
+    broadcast(msg, text);
+}
+
+bool Table::isOpen() const {
+    return !started && phase == Phase::Lobby && seats.size() < maxPlayers;
+}
+
+void Table::join(Connection* c, const std::string& name) {
+    auto existing = playersByConn.find(c);
+    bool rejoin = existing != playersByConn.end();
+    if (!rejoin) seats.push_back(c);
+    c->table = this;
+    PlayerInfo info{ c, name, Rules::dicePerPlayer, true, rejoin ? existing->second.id : freePlayerId() };
+    playersByConn[c] = info;
+    std::cout << "Server: HELLO from " << name << " (table " << id << ")\n";
+    if (c->protocol) sendSnapshot(c);
+    else c->sendLine("WELCOME " + name);
+
+    // Everybody else only needs the newcomer; a text newcomer has no
+    // snapshot, so it gets the other players' counts as lines instead.
+    publish(proto::Player{ 0, info.id, name }, "");
+    broadcastDiceCount(info);
+    if (!c->protocol) {
+        for (auto& kv : playersByConn) {
+            if (kv.first != c) c->sendLine(diceCountLine(kv.second));
+        }
+    }
+}
+
+void Table::leave(Connection* c) {
+    std::string name = nameOf(c);
+    auto me = playersByConn.find(c);
+    sf::Uint8 playerId = me != playersByConn.end() ? me->second.id : proto::NoPlayer;
+    std::cout << "Server: disconnected " << name << " (table " << id << ")\n";
+    Connection* turnHolder = turnOrder.empty() ? nullptr : turnOrder[turnIndex];
+
+    c->table = nullptr;
+    playersByConn.erase(c);
+    seats.erase(std::remove(seats.begin(), seats.end(), c), seats.end());
+    turnOrder.erase(std::remove(turnOrder.begin(), turnOrder.end(), c), turnOrder.end());
+
+    // Keep the turn where it was; if the leaver had it, it passes on
+    auto holder = std::find(turnOrder.begin(), turnOrder.end(), turnHolder);
+    if (holder != turnOrder.end()) turnIndex = (int)(holder - turnOrder.begin());
+    else if (turnIndex >= (int)turnOrder.size()) turnIndex = 0;
+
+    if (playerId != proto::NoPlayer) publish(proto::Player{ 0, playerId, "" }, "LEFT " + name);
+    if (turnHolder == c) broadcastTurn();
+}
+
+void Table::sendSnapshot(Connection* c) {
+    if (!c->protocol) return;
+    auto me = playersByConn.find(c);
+
+    proto::Snapshot snap;
+    snap.seq = seq;
+    snap.you = me != playersByConn.end() ? me->second.id : proto::NoPlayer;
+    snap.phase = static_cast<proto::PhaseId>(phase); // same order as Table::Phase
+    if (!turnOrder.empty()) snap.turn = playersByConn[turnOrder[turnIndex]].id;
+    if (currentBetCount > 0) {
+        snap.better = idOf(currentBetter);
+        snap.count = (sf::Uint8)currentBetCount;
+        snap.face = (sf::Uint8)currentBetFace;
+    }
+    for (auto* s : seats) {
+        const PlayerInfo& pi = playersByConn[s];
+        proto::SeatState seat{ pi.id, pi.name, (sf::Uint8)pi.diceCount, {} };
+        const perudo::DicePool::Hand* hand = roundDice.find(pi.id);
+        if (phase == Phase::Reveal && hand) seat.revealed = toDice(roundDice, *hand);
+        snap.seats.push_back(std::move(seat));
+    }
+    if (me != playersByConn.end()) {
+        const perudo::DicePool::Hand* hand = roundDice.find(me->second.id);
+        if (hand) snap.myDice = toDice(roundDice, *hand);
+    }
+    send(c, snap, "");
+}
+
+// ---- Commands ----
+void Table::onRoll(Connection* client) {
+    // Only meaningful in Lobby/after reveal (first round is started by first R)
+    if (turnOrder.empty())
+        firstRoundStarter = nameOf(client);
+    started = true;
+
+    setupTurnOrderIfNeeded();
+    rollAllDice();
+    sendPrivateDiceToOwners(); // give each client their own dice
+    publish(proto::Phase{ 0, proto::PhaseId::Betting }, "PHASE BETTING");
+    phase = Phase::Betting;
+    currentBetter.clear();
+    currentBetCount = 0;
+    currentBetFace = 0;
+    startBettingIfPossible();
+}
+
+void Table::onBet(Connection* client, int count, int face) {
+    if (phase != Phase::Betting) return;
+
+    if (turnOrder.empty() || turnOrder[turnIndex] != client) {
+        send(client, proto::Reject{ proto::RejectId::NotYourTurn }, "INFO NotYourTurn");
+        return;
+    }
+    if (!isValidRaise(count, face)) {
+        send(client, proto::Reject{ proto::RejectId::InvalidBet }, "INFO InvalidBet");
+        return;
+    }
+    currentBetCount = count;
+    currentBetFace = face;
+    currentBetter = nameOf(client);
+
+    broadcastCurrentBet();
+    advanceTurn();
+}
+
+void Table::onDoubt(Connection* client) {
+    if (phase != Phase::Betting) return;
+    resolveDoubt(client);
+}
+
+void Table::onNext() {
+    if (phase == Phase::Reveal) beginNextRound();
+}
+
+std::string Table::nameOf(Connection* s) const {
+    auto it = playersByConn.find(s);
+    if (it == playersByConn.end()) return "Unknown";
+    return it->second.name;
+}
+
+std::string Table::nameById(sf::Uint8 id) const {
+    for (auto& kv : playersByConn) {
+        if (kv.second.id == id) return kv.second.name;
+    }
+    return "Unknown";
+}
+
+sf::Uint8 Table::idOf(const std::string& name) const {
+    for (auto& kv : playersByConn) {
+        if (kv.second.name == name) return kv.second.id;
+    }
+    return proto::NoPlayer;
+}
+
+Table::PlayerInfo* Table::getPlayerByName(const std::string& name) {
+    for (auto& kv : playersByConn) {
+        if (kv.second.name == name) return &kv.second;
+    }
+    return nullptr;
+}
+
+sf::Uint8 Table::freePlayerId() const {
+    for (sf::Uint8 candidate = 0; candidate < proto::NoPlayer; ++candidate) {
+        bool used = false;
+        for (auto& kv : playersByConn) used = used || kv.second.id == candidate;
+        if (!used) return candidate;
+    }
+    return proto::NoPlayer;
+}
+
+void Table::setupTurnOrderIfNeeded() {
+    if (!turnOrder.empty()) return;
+    for (auto* s : seats) {
+        if (playersByConn.count(s) && playersByConn[s].diceCount > 0)
+            turnOrder.push_back(s);
+    }
+    turnIndex = 0;
+}
+
+void Table::startBettingIfPossible() {
+    if (turnOrder.empty()) setupTurnOrderIfNeeded();
+    int attempts = 0;
+    while (!turnOrder.empty() && playersByConn[turnOrder[turnIndex]].diceCount <= 0 && attempts < (int)turnOrder.size()) {
+        turnIndex = (turnIndex + 1) % (int)turnOrder.size();
+        attempts++;
+    }
+    if (!turnOrder.empty()) broadcastTurn();
+    broadcastCurrentBet();
+}
+
+void Table::advanceTurn() {
+    if (turnOrder.empty()) return;
+    int n = (int)turnOrder.size();
+    for (int i = 0; i < n; ++i) {
+        turnIndex = (turnIndex + 1) % n;
+        auto* s = turnOrder[turnIndex];
+        if (playersByConn[s].diceCount > 0) break;
+    }
+    broadcastTurn();
+}
+
+void Table::broadcastDiceCount(const PlayerInfo& pi) {
+    publish(proto::DiceCount{ 0, pi.id, (sf::Uint8)pi.diceCount }, diceCountLine(pi));
+}
+void Table::broadcastTurn() {
+    if (turnOrder.empty()) return;
+    Connection* c = turnOrder[turnIndex];
+    publish(proto::Turn{ 0, playersByConn[c].id }, "TURN " + nameOf(c));
+}
+void Table::broadcastCurrentBet() {
+    if (currentBetCount == 0) publish(proto::CurrentBet{}, "CURRENTBET None 0 0");
+    else {
+        std::ostringstream oss;
+        oss << "CURRENTBET " << currentBetter << ' ' << currentBetCount << ' ' << currentBetFace;
+        proto::CurrentBet bet{ 0, idOf(currentBetter), (sf::Uint8)currentBetCount, (sf::Uint8)currentBetFace };
+        publish(bet, oss.str());
+    }
+}
+
+void Table::broadcastRevealAll() {
+    phase = Phase::Reveal;
+    publish(proto::Phase{ 0, proto::PhaseId::Reveal }, "PHASE REVEAL");
+    for (const auto& hand : roundDice.getHands()) {
+        std::ostringstream oss;
+        oss << "REVEAL " << nameById(hand.owner);
+        for (auto* d = roundDice.begin(hand); d != roundDice.end(hand); ++d) oss << ' ' << (int)*d;
+        publish(proto::Reveal{ 0, hand.owner, toDice(roundDice, hand) }, oss.str());
+    }
+}
+
+void Table::rollAllDice() {
+    roundDice.clear();
+    // Dealt in join order, not map order: playersByConn is keyed by
+    // address, and a seeded table has to deal the same hands every run
+    for (auto* s : seats) {
+        const PlayerInfo& pi = playersByConn[s];
+        if (pi.diceCount > 0) roundDice.add(pi.id, pi.diceCount);
+    }
+    rng.rollD6(roundDice.data(), roundDice.size()); // the whole table in one batch
+    roundDice.tally(); // every count for the rest of the round is a lookup
+    // Dice counts only change in resolveDoubt, so a roll publishes none
+}
+
+void Table::sendPrivateDiceToOwners() {
+    for (auto* s : seats) {
+        const perudo::DicePool::Hand* hand = roundDice.find(playersByConn[s].id);
+        if (!hand) continue;
+        std::ostringstream oss;
+        oss << "MYDICE";
+        for (auto* d = roundDice.begin(*hand); d != roundDice.end(*hand); ++d) oss << ' ' << (int)*d;
+        send(s, proto::MyDice{ toDice(roundDice, *hand) }, oss.str());
+    }
+}
+
+int Table::countMatching(int betFace) const {
+    return perudo::countMatching<Rules>(roundDice, (sf::Uint8)betFace, isPalificoRound());
+}
+
+perudo::RoundState Table::roundState() const {
+    perudo::RoundState round;
+    round.bid = { (sf::Uint8)currentBetCount, (sf::Uint8)currentBetFace };
+    if (!turnOrder.empty()) {
+        auto it = playersByConn.find(turnOrder[turnIndex]);
+        if (it != playersByConn.end()) round.turnDice = (sf::Uint8)it->second.diceCount;
+    }
+    return round;
+}
+
+bool Table::isPalificoRound() const {
+    return perudo::isPalifico<Rules>(roundState());
+}
+
+bool Table::isValidRaise(int newCount, int newFace) const {
+    // Text clients can send anything; the rules work on protocol-sized values
+    if (newFace < 1 || newFace > 6 || newCount <= 0 || newCount > 255) return false;
+    return perudo::isValidRaise<Rules>(roundState(), { (sf::Uint8)newCount, (sf::Uint8)newFace });
+}
+
+void Table::resolveDoubt(Connection* challenger) {
+    if (currentBetCount == 0 || currentBetFace == 0 || currentBetter.empty()) return;
+
+    broadcastRevealAll(); // sends everyone’s dice
+    phase = Phase::Reveal;
+
+    int matches = countMatching(currentBetFace);
+    bool betHolds = perudo::bidHolds({ (sf::Uint8)currentBetCount, (sf::Uint8)currentBetFace }, matches);
+
+    std::string bettor = currentBetter;
+    std::string challengerName = nameOf(challenger);
+    std::string loser = betHolds ? challengerName : bettor;
+    lastRoundLoser = loser;
+
+    auto* loserP = getPlayerByName(loser);
+    if (loserP && loserP->diceCount > 0) {
+        loserP->diceCount--;
+        proto::Info lost{ 0, proto::InfoId::LostDie, loserP->id, (sf::Uint8)loserP->diceCount };
+        publish(lost, "INFO LostDie " + loser + " " + std::to_string(loserP->diceCount));
+        broadcastDiceCount(*loserP); // the only count that changed
+        if (loserP->diceCount == 0)
+            publish(proto::Info{ 0, proto::InfoId::Eliminated, loserP->id, 0 }, "INFO Eliminated " + loser);
+    }
+
+    int alive = 0;
+    for (auto& kv : playersByConn) if (kv.second.diceCount > 0) alive++;
+    if (alive < 2) {
+        std::string winner = "Unknown";
+        for (auto& kv : playersByConn) if (kv.second.diceCount > 0) winner = kv.second.name;
+        publish(proto::Info{ 0, proto::InfoId::Winner, idOf(winner), 0 }, "INFO Winner " + winner);
+        phase = Phase::Lobby;
+    }
+}
+
+void Table::beginNextRound() {
+    // opener = loser of last round; if none (first round), the first roller.
+    // A loser who was just eliminated passes the opening to the next live seat.
+    std::string openerName = !lastRoundLoser.empty() ? lastRoundLoser : firstRoundStarter;
+    Connection* opener = nullptr;
+    int n = (int)turnOrder.size();
+    for (int i = 0; i < n && !opener; ++i) {
+        if (nameOf(turnOrder[i]) != openerName) continue;
+        for (int k = 0; k < n; ++k) {
+            Connection* s = turnOrder[(i + k) % n];
+            if (playersByConn.count(s) && playersByConn[s].diceCount > 0) { opener = s; break; }
+        }
+    }
+
+    // prune eliminated
+    turnOrder.erase(
+        std::remove_if(turnOrder.begin(), turnOrder.end(),
+            [&](Connection* s) { return !playersByConn.count(s) || playersByConn[s].diceCount <= 0; }),
+        turnOrder.end()
+    );
+    if (turnOrder.empty()) setupTurnOrderIfNeeded();
+
+    currentBetCount = currentBetFace = 0;
+    currentBetter.clear();
+
+    rollAllDice();
+    sendPrivateDiceToOwners(); // so clients update their own dice immediately
+
+    publish(proto::Phase{ 0, proto::PhaseId::Betting }, "PHASE BETTING");
+    phase = Phase::Betting;
+
+    if (!turnOrder.empty()) {
+        auto it = std::find(turnOrder.begin(), turnOrder.end(), opener);
+        turnIndex = it != turnOrder.end() ? (int)(it - turnOrder.begin()) : 0;
+        broadcastTurn();
+    }
+    broadcastCurrentBet();
+}
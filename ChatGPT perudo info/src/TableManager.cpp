@@ -0,0 +1,71 @@
+#include "TableManager.h"
+#include <iostream>
+
+TableManager::TableManager(std::size_t seatsPerTable, int firstId, int idStride, std::uint64_t diceSeed)
+    : seatsPerTable(seatsPerTable), nextTableId(firstId), idStride(idStride), diceSeed(diceSeed) {
+}
+
+Table& TableManager::seat(Connection* c, const std::string& name) {
+    Table* table = nullptr;
+    while (!openTables.empty() && !table) {
+        auto it = openTables.begin();
+        Table* candidate = tables[*it].get();
+        if (candidate->isOpen()) table = candidate;
+        else openTables.erase(it); // filled up or game started since
+    }
+
+    if (!table) {
+        int id = nextTableId;
+        nextTableId += idStride;
+        auto created = std::make_unique<Table>(id, seatsPerTable, diceSeed);
+        table = created.get();
+        tables[id] = std::move(created);
+        openTables.insert(id);
+        std::cout << "Server: opened table " << id << " (" << tables.size() << " active)\n";
+    }
+
+    table->join(c, name);
+    if (!table->isOpen()) openTables.erase(table->getId());
+    return *table;
+}
+
+void TableManager::unseat(Connection* c) {
+    Table* table = c->table;
+    if (!table) return;
+    table->leave(c);
+
+    int id = table->getId();
+    if (table->isEmpty()) {
+        openTables.erase(id);
+        tables.erase(id);
+        std::cout << "Server: closed table " << id << " (" << tables.size() << " active)\n";
+    }
+    else if (table->isOpen()) {
+        openTables.insert(id);
+    }
+}
+
+Table* TableManager::findMovable(std::size_t maxPlayers) const {
+    Table* best = nullptr;
+    for (auto& kv : tables) {
+        Table* t = kv.second.get();
+        if (t->playerCount() > maxPlayers) continue;
+        if (!best || t->playerCount() > best->playerCount()) best = t;
+    }
+    return best;
+}
+
+std::unique_ptr<Table> TableManager::release(int id) {
+    auto it = tables.find(id);
+    if (it == tables.end()) return nullptr;
+    std::unique_ptr<Table> table = std::move(it->second);
+    tables.erase(it);
+    openTables.erase(id);
+    return table;
+}
+
+void TableManager::adopt(std::unique_ptr<Table> table) {
+    int id = table->getId();
+    if (table->isOpen()) openTables.insert(id);
+    tables[id] = std::move(table);
+}
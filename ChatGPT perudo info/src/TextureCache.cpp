@@ -0,0 +1,53 @@
+#include "TextureCache.h"
+#include <iostream>
+
+TextureCache::TextureCache(std::size_t budgetBytes)
+    : budget(budgetBytes) {
+}
+
+TextureHandle TextureCache::get(const std::string& filename) {
+    auto it = entries.find(filename);
+    if (it != entries.end()) {
+        stats.hits++;
+        lru.splice(lru.begin(), lru, it->second.lru);
+        return it->second.texture;
+    }
+
+    stats.misses++;
+    auto texture = std::make_shared<sf::Texture>();
+    if (!texture->loadFromFile(filename)) {
+        std::cerr << "Error: could not load texture " << filename << std::endl;
+        stats.failures++;
+        return nullptr;
+    }
+
+    sf::Vector2u size = texture->getSize();
+    std::size_t bytes = std::size_t(size.x) * size.y * 4; // RGBA8
+    lru.push_front(filename);
+    entries[filename] = Entry{ texture, bytes, lru.begin() };
+    stats.bytes += bytes;
+    stats.entries = entries.size();
+
+    trim();
+    return texture;
+}
+
+void TextureCache::setBudget(std::size_t budgetBytes) {
+    budget = budgetBytes;
+    trim();
+}
+
+void TextureCache::trim() {
+    // Oldest first; skip anything a handle still points at
+    for (auto it = lru.end(); stats.bytes > budget && it != lru.begin();) {
+        --it;
+        auto entry = entries.find(*it);
+        if (entry->second.texture.use_count() > 1) continue;
+
+        stats.bytes -= entry->second.bytes;
+        stats.evictions++;
+        entries.erase(entry);
+        it = lru.erase(it);
+    }
+    stats.entries = entries.size();
+}
@@ -1,22 +1,20 @@
 ﻿#include <SFML/Graphics.hpp>
 #include "ResourceManager.h"
 #include "SeatManager.h"
+#include "DiceBatch.h"
+#include "AssetLoader.h"
+#include "Hud.h"
+#include "Animator.h"
 #include "Client.h"
+#include "PerudoRules.h"
 #include <iostream>
 #include <vector>
 #include <map>
-#include <cmath>
 #include <string>
 #include <algorithm>
 #include <random>
 
 // ---------- helpers ----------
-static void scaleSpriteToFit(sf::Sprite& sprite, float targetW, float targetH) {
-    sf::FloatRect b = sprite.getLocalBounds();
-    if (b.width == 0 || b.height == 0) return;
-    sprite.setScale(targetW / b.width, targetH / b.height);
-}
-
 struct Button {
     sf::FloatRect rect;
     std::string label;
@@ -32,37 +30,44 @@ int main(int argc, char* argv[]) {
     if (argc > 1) username = argv[1];
 
     sf::RenderWindow window(sf::VideoMode(1000, 720), "Perudo - Multiplayer (Client)");
-    window.setFramerateLimit(60);
 
-    sf::Font font;
-    bool hasFont = font.loadFromFile("assets/fonts/OpenSans-Regular.ttf");
+    // Assets and the connection both arrive in the background; frames are
+    // drawn from the start with whatever is ready.
+    std::vector<std::pair<std::string, std::string>> images; // dice faces and the cup share one atlas
+    for (int i = 1; i <= 6; ++i)
+        images.push_back({ "die" + std::to_string(i), "assets/dice/die" + std::to_string(i) + ".png" });
+    images.push_back({ "cup", "assets/cup.png" });
+    AssetLoader assets(images, "assets/fonts/OpenSans-Regular.ttf");
 
     SeatManager seats(window.getSize().x, window.getSize().y);
 
     Client client;
     client.connectToServer("127.0.0.1", 54000, username);
 
-    // Textures
-    std::vector<sf::Texture*> diceTex;
-    for (int i = 1; i <= 6; ++i)
-        diceTex.push_back(&ResourceManager::getTexture("assets/dice/die" + std::to_string(i) + ".png"));
-    sf::Texture* cupTex = &ResourceManager::getTexture("assets/cup.png");
+    // All dice and cups: seat 0 is me, seats 1..7 are opponents
+    const int maxSeats = 8;
+    DiceBatch batch(maxSeats);
+    bool tableReady = false; // atlas uploaded and registered with the batch
+    std::vector<int> faceImage;
+    int cupImage = -1;
 
-    // My dice sprites
-    std::vector<sf::Sprite> myDiceSprites(5);
-    for (auto& s : myDiceSprites) { s.setTexture(*diceTex[0]); scaleSpriteToFit(s, 64.f, 64.f); }
+    // Faces shown for my dice once the roll animation is over
+    std::vector<int> myFaces(5, 1);
 
     std::vector<std::string> seatNames; seatNames.push_back(username);
 
     // HUD selection state
     int selCount = 1, selFace = 2;
 
-    auto makeText = [&](const std::string& str, unsigned size, float x, float y) {
-        sf::Text t;
-        if (hasFont) { t.setFont(font); t.setCharacterSize(size); t.setFillColor(sf::Color::White); }
-        t.setString(str); t.setPosition(x, y);
-        return t;
-        };
+    // Same rules as the server, which still has the final word; checking
+    // here saves a round trip and lets the HUD flag a bet it would refuse.
+    auto selectionValid = [&] {
+        perudo::RoundState round;
+        round.bid = { (sf::Uint8)client.currentBetCount, (sf::Uint8)client.currentBetFace };
+        auto turn = client.players.find(client.currentTurn);
+        if (turn != client.players.end()) round.turnDice = (sf::Uint8)turn->second.diceCount;
+        return perudo::isValidRaise<perudo::StandardRules>(round, { (sf::Uint8)selCount, (sf::Uint8)selFace });
+    };
 
     // Buttons (layout top-right)
     std::vector<Button> buttons = {
@@ -75,12 +80,60 @@ int main(int argc, char* argv[]) {
         {{680, 188, 190, 34}, "NEXT ROUND"}
     };
 
-    // Rolling animation
-    bool rolling = false;
-    sf::Clock rollClock;
+    // HUD text and buttons, built once and updated only on change
+    Hud hud(maxSeats);
+    for (const auto& b : buttons) hud.addButton(b.rect, b.label);
+
+    // Animations run on the Animator's fixed clock, not per frame: your
+    // dice tumble after every MYDICE, and at a reveal each opponent's cup
+    // lifts before their dice pop in.
+    Animator anim;
+    sf::Clock frameClock;
+
     const float rollDuration = 1.0f; // seconds
+    const int rollFlips = 12;        // faces shown while a die tumbles, picked once per roll
+    unsigned seenDiceSerial = 0;
     std::mt19937 rng{ std::random_device{}() };
     std::uniform_int_distribution<> faceDist(1, 6);
+    std::vector<std::vector<int>> tumbleFaces(myFaces.size(), std::vector<int>(rollFlips, 1));
+
+    std::vector<Animator::Id> rollAnim;
+    Timeline roll;
+    for (std::size_t i = 0; i < myFaces.size(); ++i) {
+        rollAnim.push_back(anim.add(1.f));
+        roll.add(0.06f * i, rollAnim[i], 0.f, 1.f, rollDuration - 0.06f * i, Ease::OutCubic);
+    }
+
+    std::vector<Animator::Id> liftAnim, popAnim;
+    std::vector<Timeline> reveal(maxSeats);
+    std::vector<bool> seatRevealed(maxSeats, false);
+    for (int p = 0; p < maxSeats; ++p) {
+        liftAnim.push_back(anim.add(0.f));
+        popAnim.push_back(anim.add(1.f));
+        reveal[p].add(0.f, liftAnim[p], 0.f, 1.f, 0.35f, Ease::InOutQuad)
+                 .add(0.25f, popAnim[p], 0.f, 1.f, 0.3f, Ease::OutBack);
+    }
+    auto coverSeat = [&](int p) { // cup back down, no transition
+        anim.set(liftAnim[p], 0.f);
+        anim.set(popAnim[p], 1.f);
+    };
+
+    // Frames are only drawn when something visible changed: input, network
+    // state, loading progress or a running animation, and at most
+    // frameInterval apart. Otherwise the loop sleeps until the network
+    // thread has news, the next animation starts moving, or it is time to
+    // look at input again. SFML has no wait covering both the window and
+    // the socket (its own waitEvent() polls every 10 ms), so input is still
+    // polled, backing off the longer nothing happens.
+    const sf::Time frameInterval = sf::seconds(1.f / 60.f);
+    sf::Clock sinceFrame, sinceActivity;
+    bool dirty = true;
+    bool focused = true;
+
+    auto idleWait = [&] {
+        if (!focused) return sf::milliseconds(250);
+        return sinceActivity.getElapsedTime() < sf::seconds(1) ? sf::milliseconds(15) : sf::milliseconds(60);
+    };
 
     std::cout << "Controls: Use buttons or keys: R (start once), B/Enter (Bet), D (Doubt)\n";
 
@@ -88,7 +141,16 @@ int main(int argc, char* argv[]) {
         // ---- Input ----
         sf::Event e;
         while (window.pollEvent(e)) {
+            dirty = true;
             if (e.type == sf::Event::Closed) window.close();
+            if (e.type == sf::Event::LostFocus) focused = false;
+            if (e.type == sf::Event::GainedFocus) focused = true;
+            if (e.type == sf::Event::Resized) {
+                // Keep one view unit per pixel; seats are laid out for the new size
+                float w = (float)e.size.width, h = (float)e.size.height;
+                window.setView(sf::View(sf::FloatRect(0.f, 0.f, w, h)));
+                seats.setWindowSize(w, h);
+            }
 
             if (e.type == sf::Event::MouseButtonPressed && e.mouseButton.button == sf::Mouse::Left) {
                 sf::Vector2f mp((float)e.mouseButton.x, (float)e.mouseButton.y);
@@ -97,7 +159,7 @@ int main(int argc, char* argv[]) {
                 else if (hit(buttons[1], mp)) selCount = std::max(selCount - 1, 1);
                 else if (hit(buttons[2], mp)) selFace = std::min(selFace + 1, 6);
                 else if (hit(buttons[3], mp)) selFace = std::max(selFace - 1, 1);
-                else if (hit(buttons[4], mp)) client.sendBet(selCount, selFace);
+                else if (hit(buttons[4], mp) && selectionValid()) client.sendBet(selCount, selFace);
                 else if (hit(buttons[5], mp)) client.sendDoubt();
                 else if (hit(buttons[6], mp)) client.sendNextRound();
             }
@@ -105,7 +167,7 @@ int main(int argc, char* argv[]) {
             if (e.type == sf::Event::KeyPressed) {
                 if (e.key.code == sf::Keyboard::R) client.requestRoll(); // only works once
                 if (e.key.code == sf::Keyboard::D) client.sendDoubt();
-                if (e.key.code == sf::Keyboard::Enter || e.key.code == sf::Keyboard::B) client.sendBet(selCount, selFace);
+                if ((e.key.code == sf::Keyboard::Enter || e.key.code == sf::Keyboard::B) && selectionValid()) client.sendBet(selCount, selFace);
                 if (e.key.code == sf::Keyboard::Up)   selCount = std::min(selCount + 1, 50);
                 if (e.key.code == sf::Keyboard::Down) selCount = std::max(selCount - 1, 1);
                 if (e.key.code >= sf::Keyboard::Num1 && e.key.code <= sf::Keyboard::Num6)
@@ -113,138 +175,143 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        // ---- Network ----
-        client.poll();
+        // ---- Assets ----
+        if (assets.loading()) dirty = true; // includes the frame it finishes on
+        assets.update(sf::milliseconds(4));
+        if (!hud.hasFont() && assets.fontReady()) hud.setFont(assets.getFont());
+        if (!tableReady && assets.atlasReady()) {
+            auto addRegion = [&](const std::string& name) {
+                const AtlasRegion& r = ResourceManager::getRegion(name);
+                return batch.addImage(*r.texture, r.rect);
+            };
+            for (int i = 1; i <= 6; ++i) faceImage.push_back(addRegion("die" + std::to_string(i)));
+            cupImage = addRegion("cup");
+            tableReady = true;
+        }
 
-        // Trigger animation on first R (ROLL) and whenever we get our MYDICE
-        if (!rolling && (client.lastMessage.rfind("MYDICE", 0) == 0)) {
-            rolling = true;
-            rollClock.restart();
+        // ---- Network ----
+        if (client.poll() > 0) dirty = true;
+
+        // Start a roll whenever new MYDICE arrived during this poll
+        if (client.myDiceSerial != seenDiceSerial) {
+            seenDiceSerial = client.myDiceSerial;
+            for (auto& faces : tumbleFaces)
+                for (int& f : faces) f = faceDist(rng);
+            roll.play(anim);
         }
 
+        // ---- Animation ----
+        if (anim.update(frameClock.restart())) dirty = true;
+
+        if (!dirty || sinceFrame.getElapsedTime() < frameInterval) {
+            if (dirty) sinceActivity.restart();
+            sf::Time untilFrame = frameInterval - sinceFrame.getElapsedTime();
+            sf::Time wait = dirty ? untilFrame : idleWait();
+            if (anim.anyRunning()) wait = std::min(wait, std::max(anim.untilNextChange(), untilFrame));
+            client.waitForEvents(std::max(wait, sf::Time::Zero));
+            continue;
+        }
+        dirty = false;
+        sinceFrame.restart();
+        sinceActivity.restart();
 
         // update list of names (me first, then others)
         seatNames.resize(1);
         for (auto& kv : client.players) {
             if (kv.first != username) seatNames.push_back(kv.first);
-            if ((int)seatNames.size() >= 8) break; // show up to 8 players
+            if ((int)seatNames.size() >= maxSeats) break; // show up to 8 players
         }
         int totalPlayers = std::max(1, (int)seatNames.size());
 
-        // If MYDICE arrived, and we’re not currently rolling, set my sprites to actual faces
+        // Real faces; they show through as soon as each die stops tumbling
         auto itMe = client.players.find(username);
         bool haveMyDice = (itMe != client.players.end() && !itMe->second.revealedDice.empty());
 
-        if (!rolling && haveMyDice) {
-            for (int i = 0; i < (int)myDiceSprites.size(); ++i) {
+        if (haveMyDice) {
+            for (int i = 0; i < (int)myFaces.size(); ++i) {
                 int face = (i < (int)itMe->second.revealedDice.size()) ? itMe->second.revealedDice[i] : 1;
-                myDiceSprites[i].setTexture(*diceTex[std::clamp(face, 1, 6) - 1]);
+                myFaces[i] = std::clamp(face, 1, 6);
             }
         }
 
         // ---- Draw ----
         window.clear(sf::Color(30, 120, 50));
 
-        // Opponents
-        for (int p = 1; p < totalPlayers; ++p) {
-            sf::Vector2f seat = seats.getSeatPosition(p, totalPlayers);
-            const std::string& name = seatNames[p];
-            auto it = client.players.find(name);
-            bool revealed = (client.phase == "REVEAL" && it != client.players.end() && !it->second.revealedDice.empty());
-
-            if (!revealed) {
-                sf::Sprite cup(*cupTex);
-                scaleSpriteToFit(cup, 120.f, 120.f);
-                cup.setOrigin(cup.getLocalBounds().width / 2.f, cup.getLocalBounds().height / 2.f);
-                cup.setPosition(seat);
-                window.draw(cup);
-            }
-            else {
-                float R = 60.f;
-                int n = (int)it->second.revealedDice.size();
-                for (int i = 0; i < n; ++i) {
-                    sf::Sprite d(*diceTex[std::clamp(it->second.revealedDice[i], 1, 6) - 1]);
-                    scaleSpriteToFit(d, 50.f, 50.f);
-                    d.setOrigin(d.getLocalBounds().width / 2.f, d.getLocalBounds().height / 2.f);
-                    float angle = i * (2.f * 3.14159f / std::max(1, n)) - 3.14159f / 2.f;
-                    d.setPosition(seat.x + R * std::cos(angle), seat.y + R * std::sin(angle));
-                    window.draw(d);
-                }
-            }
-
-            // opponent name + dice count
-            if (hasFont) {
-                int dcount = (client.players.count(name) ? client.players[name].diceCount : 0);
-                auto t = makeText(name + " (" + std::to_string(dcount) + ")", 18, seat.x - 60, seat.y + 70);
-                window.draw(t);
-            }
-        }
+        const SeatLayout& layout = seats.layout(totalPlayers, DiceBatch::slotsPerSeat - 1);
+
+        if (tableReady) {
+            // Opponents: a cup, or the revealed dice around the seat
+            for (int p = 1; p < maxSeats; ++p) {
+                int shown = 0;   // dice slots in use
+                bool cup = false;
+                if (p < totalPlayers) {
+                    sf::Vector2f seat = layout.seats[p];
+                    auto it = client.players.find(seatNames[p]);
+                    bool revealed = (client.phase == "REVEAL" && it != client.players.end() && !it->second.revealedDice.empty());
+
+                    if (revealed != seatRevealed[p]) {
+                        seatRevealed[p] = revealed;
+                        if (revealed) reveal[p].play(anim);
+                        else coverSeat(p);
+                    }
 
-        // Me (seat 0) — draw pentagon of dice
-        {
-            sf::Vector2f center = seats.getSeatPosition(0, totalPlayers);
-            float R = 90.f;
-            int n = (int)myDiceSprites.size();
-
-            for (int i = 0; i < n; ++i) {
-                // rolling animation: show random faces until timer ends
-                if (rolling) {
-                    // During animation, only show random faces
-                    int rf = faceDist(rng);
-                    myDiceSprites[i].setTexture(*diceTex[rf - 1]);
+                    float lift = anim.value(liftAnim[p]);
+                    if (lift < 1.f) {
+                        sf::Vector2f at(seat.x, seat.y - 80.f * lift);
+                        batch.place(DiceBatch::slotOf(p, 0), cupImage, at, { 120.f, 120.f });
+                        cup = true;
+                    }
+                    if (revealed) {
+                        float size = 50.f * std::max(anim.value(popAnim[p]), 0.f);
+                        int n = std::min((int)it->second.revealedDice.size(), (int)DiceBatch::slotsPerSeat - 1);
+                        for (int i = 0; i < n; ++i) {
+                            sf::Vector2f pos = layout.die(p, i, n);
+                            int face = std::clamp(it->second.revealedDice[i], 1, 6);
+                            batch.place(DiceBatch::slotOf(p, i + 1), faceImage[face - 1], pos, { size, size });
+                        }
+                        shown = n;
+                    }
                 }
-                else if (!rolling && haveMyDice) {
-                    // Only apply real faces *after* rolling finishes
-                    int face = (i < (int)itMe->second.revealedDice.size()) ? itMe->second.revealedDice[i] : 1;
-                    myDiceSprites[i].setTexture(*diceTex[std::clamp(face, 1, 6) - 1]);
+                else if (seatRevealed[p]) {
+                    seatRevealed[p] = false;
+                    coverSeat(p);
                 }
-
-                myDiceSprites[i].setOrigin(myDiceSprites[i].getLocalBounds().width / 2.f,
-                    myDiceSprites[i].getLocalBounds().height / 2.f);
-
-                float angle = i * (2.f * 3.14159f / n) - 3.14159f / 2.f;
-                myDiceSprites[i].setPosition(center.x + R * std::cos(angle),
-                    center.y + R * std::sin(angle));
-                window.draw(myDiceSprites[i]);
+                if (!cup) batch.hide(DiceBatch::slotOf(p, 0));
+                for (int i = shown; i < (int)DiceBatch::slotsPerSeat - 1; ++i) batch.hide(DiceBatch::slotOf(p, i + 1));
             }
 
-            // end of animation window
-            if (rolling && rollClock.getElapsedTime().asSeconds() >= rollDuration) {
-                rolling = false;
-                // lock in actual faces if we have them
-                if (haveMyDice) {
-                    for (int i = 0; i < (int)myDiceSprites.size(); ++i) {
-                        int face = (i < (int)itMe->second.revealedDice.size()) ? itMe->second.revealedDice[i] : 1;
-                        myDiceSprites[i].setTexture(*diceTex[std::clamp(face, 1, 6) - 1]);
+            // Me (seat 0) — pentagon of dice
+            {
+                int n = std::min((int)myFaces.size(), layout.dice);
+
+                for (int i = 0; i < n; ++i) {
+                    // While tumbling, flip through this roll's faces (slowing as
+                    // the ease does) and hop once; then settle on the real face.
+                    sf::Vector2f pos = layout.die(0, i, n);
+                    int face = myFaces[i];
+                    if (anim.running(rollAnim[i])) {
+                        float t = anim.value(rollAnim[i]);
+                        face = tumbleFaces[i][std::min((int)(t * rollFlips), rollFlips - 1)];
+                        pos.y -= 4.f * t * (1.f - t) * 24.f;
                     }
+                    batch.place(DiceBatch::slotOf(0, i + 1), faceImage[face - 1], pos, { 64.f, 64.f });
                 }
             }
-        }
 
-        // HUD text / current state
-        if (hasFont) {
-            std::string betStr = client.currentBetCount > 0
-                ? (client.currentBetter + ": " + std::to_string(client.currentBetCount) + " x " + std::to_string(client.currentBetFace) + "s")
-                : "No bet yet";
-
-            auto t1 = makeText("Phase: " + client.phase + "    Turn: " + client.currentTurn, 20, 14, 10);
-            auto t2 = makeText("Current Bet: " + betStr, 20, 14, 36);
-            auto t3 = makeText("Select -> Count: " + std::to_string(selCount) + "  Face: " + std::to_string(selFace), 18, 14, 62);
-            window.draw(t1); window.draw(t2); window.draw(t3);
+            batch.draw(window);
         }
 
-        // Draw buttons
-        if (hasFont) {
-            for (const auto& b : buttons) {
-                sf::RectangleShape rect; rect.setPosition(b.rect.left, b.rect.top);
-                rect.setSize({ b.rect.width, b.rect.height });
-                rect.setFillColor(sf::Color(20, 20, 20, 180));
-                rect.setOutlineColor(sf::Color::White);
-                rect.setOutlineThickness(1.f);
-                auto lbl = makeText(b.label, 18, b.rect.left + 10, b.rect.top + 5);
-                window.draw(rect); window.draw(lbl);
-            }
+        // HUD: opponent names, game state, buttons
+        for (int p = 1; p < maxSeats; ++p) {
+            if (p >= totalPlayers) { hud.hideSeat(p); continue; }
+            auto it = client.players.find(seatNames[p]);
+            int dcount = it != client.players.end() ? it->second.diceCount : 0;
+            hud.setSeat(p, seatNames[p], dcount, layout.seats[p]);
         }
+        hud.setStatus(client.connected, client.phase, client.currentTurn);
+        hud.setBet(client.currentBetter, client.currentBetCount, client.currentBetFace);
+        hud.setSelection(selCount, selFace, selectionValid());
+        hud.draw(window);
 
         window.display();
     }